@@ -239,7 +239,7 @@ extension SystemStateViewController: NSOutlineViewDelegate {
 		case 0: view?.objectValue = ("Accumulator", self.format("%02x", value: { $0.cpu.accumulator }))
 		case 1: view?.objectValue = ("X", self.format("%02x", value: { $0.cpu.x }))
 		case 2: view?.objectValue = ("Y", self.format("%02x", value: { $0.cpu.y }))
-		case 3: view?.objectValue = ("Status", self.format(status: { $0.cpu.status }))
+		case 3: view?.objectValue = ("Status", self.format(status: { state in withUnsafePointer(to: state.cpu) { racer_mcs6507_get_status($0) } }))
 		case 4: view?.objectValue = ("Stack Pointer", self.format("%02x", value: { $0.cpu.stack_pointer }))
 		default:
 			break
@@ -377,7 +377,8 @@ extension SystemStateViewController: NSOutlineViewDelegate {
 			
 		case .position:
 			let view = outlineView.makeView(withIdentifier: .debugItemTableCellView, owner: nil) as? DebugItemTableCellView
-			view?.positionValue = (item.rawValue, Int(player.position), player.motion)
+			let position = racer_tia_get_position(self.console.console.pointee.tia, player.start_position)
+			view?.positionValue = (item.rawValue, Int(position), player.motion)
 			return view
 			
 			//			case .delay:
@@ -107,7 +107,7 @@ extension Atari2600 {
 			}
 		} else {
 			while case .resumed = self.state {
-				racer_atari2600_advance_clock(self.console)
+				racer_atari2600_run_frame(self.console)
 			}
 		}
 	}
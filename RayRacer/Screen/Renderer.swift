@@ -93,6 +93,15 @@ extension Renderer: MTKViewDelegate {
 		
 		commandBuffer.commit()
 	}
+	
+	/// Blocks until every command buffer committed so far completes.
+	func finishRendering() {
+		guard let commandBuffer = self.commandQueue.makeCommandBuffer() else {
+			return
+		}
+		commandBuffer.commit()
+		commandBuffer.waitUntilCompleted()
+	}
 }
 
 
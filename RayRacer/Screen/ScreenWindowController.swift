@@ -13,7 +13,7 @@ class ScreenWindowController: NSWindowController {
 	@IBOutlet var view: MTKView!
 	@IBOutlet var label: NSTextField!
 	
-	private let renderer = Renderer()
+	private let renderer = Renderer(bufferCount: Int(RACER_THREAD_BUFFER_COUNT))
 	private let console: Atari2600
 	private var racer: OpaquePointer!
 	
@@ -50,11 +50,11 @@ class ScreenWindowController: NSWindowController {
 			block: self.updateFieldRate(_:))
 		
 		// set up emulation
-		let buffer = self.renderer.buffers[0]
-		let data = buffer.contents()
-			.assumingMemoryBound(to: UInt8.self)
+		let buffers = self.renderer.bufferContents
+		let length = self.renderer.buffers[0].length
 		
-		self.racer = racer_thread_create(self.console.console, data, buffer.length)
+		self.racer = racer_thread_create(self.console.console, buffers, length)
+		racer_thread_set_field_rate(self.racer, RACER_THREAD_NTSC_FIELD_RATE)
 		self.renderer.delegate = self
 	}
 	
@@ -66,9 +66,12 @@ class ScreenWindowController: NSWindowController {
 		
 		// reassign pointer to racer_thread to avoid capturing self from
 		// main actor; destroy racer_thread in a detached task to give
-		// racer_thread time to break out of run loop and join its thread
+		// racer_thread time to break out of run loop and join its thread,
+		// once rendering in flight has released its fields
 		let racer = self.racer
+		let renderer = self.renderer
 		Task.detached(priority: .userInitiated) {
+			renderer.finishRendering()
 			racer_thread_destroy(racer)
 		}
 	}
@@ -89,6 +92,7 @@ extension ScreenWindowController: NSWindowDelegate {
 			return
 		}
 		self.view.isPaused = false
+		racer_thread_resume(self.racer)
 	}
 	
 	func windowDidResignKey(_ notification: Notification) {
@@ -97,6 +101,7 @@ extension ScreenWindowController: NSWindowDelegate {
 			return
 		}
 		self.view.isPaused = true
+		racer_thread_pause(self.racer)
 	}
 }
 
@@ -105,15 +110,15 @@ extension ScreenWindowController: NSWindowDelegate {
 // MARK: Field rendering
 extension ScreenWindowController: RendererDelegate {
 	func rendererWillBeginRendering(_ renderer: Renderer) -> MTLBuffer? {
-		// ensure emulation has finished producing field data
-		guard racer_thread_is_paused(self.racer) else {
-			return nil
-		}
-		return renderer.buffers.first
+		// take the latest field emulation has published, without waiting
+		// for the next one
+		let index = racer_thread_acquire_field(self.racer)
+		return renderer.buffers[Int(index)]
 	}
 	
 	func rendererDidEndRendering(_ renderer: Renderer) {
-		// resume emulation to produce next field data
-		racer_thread_resume(self.racer)
+		// GPU is done reading the field, so emulation may draw into its
+		// buffer again; emulation itself never waits for rendering
+		racer_thread_release_field(self.racer)
 	}
 }
@@ -8,7 +8,9 @@
 #ifndef ntsc_palette_h
 #define ntsc_palette_h
 
-#define float4_rgb(r, g, b) { r / 255.0f, g / 255.0f, b / 250.0f, 1.0 }
+#include "palette.h"
+
+#define float4_rgb(r, g, b) { r / 255.0f, g / 255.0f, b / 255.0f, 1.0 },
 
 // expose palette to Metal
 #ifdef __METAL_VERSION__
@@ -22,134 +24,7 @@ constant float4 ntsc_palette[] = {
 const simd_float4 ntsc_palette[] = {
 
 #endif
-	float4_rgb(0x00, 0x00, 0x00),
-	float4_rgb(0x40, 0x40, 0x40),
-	float4_rgb(0x6c, 0x6c, 0x6c),
-	float4_rgb(0x90, 0x90, 0x90),
-	float4_rgb(0xb0, 0xb0, 0xb0),
-	float4_rgb(0xc8, 0xc8, 0xc8),
-	float4_rgb(0xdc, 0xdc, 0xdc),
-	float4_rgb(0xec, 0xec, 0xec),
-	float4_rgb(0x44, 0x44, 0x00),
-	float4_rgb(0x64, 0x64, 0x10),
-	float4_rgb(0x84, 0x84, 0x24),
-	float4_rgb(0xa0, 0xa0, 0x34),
-	float4_rgb(0xb8, 0xb8, 0x40),
-	float4_rgb(0xd0, 0xd0, 0x50),
-	float4_rgb(0xe8, 0xe8, 0x5c),
-	float4_rgb(0xfc, 0xfc, 0x68),
-	float4_rgb(0x70, 0x28, 0x00),
-	float4_rgb(0x84, 0x44, 0x14),
-	float4_rgb(0x98, 0x5c, 0x28),
-	float4_rgb(0xac, 0x78, 0x3c),
-	float4_rgb(0xbc, 0x8c, 0x4c),
-	float4_rgb(0xcc, 0xa0, 0x5c),
-	float4_rgb(0xdc, 0xb4, 0x68),
-	float4_rgb(0xec, 0xc8, 0x78),
-	float4_rgb(0x84, 0x18, 0x00),
-	float4_rgb(0x98, 0x34, 0x18),
-	float4_rgb(0xac, 0x50, 0x30),
-	float4_rgb(0xc0, 0x68, 0x48),
-	float4_rgb(0xd0, 0x80, 0x5c),
-	float4_rgb(0xe0, 0x94, 0x70),
-	float4_rgb(0xec, 0xa8, 0x80),
-	float4_rgb(0xfc, 0xbc, 0x94),
-	float4_rgb(0x88, 0x00, 0x00),
-	float4_rgb(0x9c, 0x20, 0x20),
-	float4_rgb(0xb0, 0x3c, 0x3c),
-	float4_rgb(0xc0, 0x58, 0x58),
-	float4_rgb(0xd0, 0x70, 0x70),
-	float4_rgb(0xe0, 0x88, 0x88),
-	float4_rgb(0xec, 0xa0, 0xa0),
-	float4_rgb(0xfc, 0xb4, 0xb4),
-	float4_rgb(0x78, 0x00, 0x5c),
-	float4_rgb(0x8c, 0x20, 0x74),
-	float4_rgb(0xa0, 0x3c, 0x88),
-	float4_rgb(0xb0, 0x58, 0x9c),
-	float4_rgb(0xc0, 0x70, 0xb0),
-	float4_rgb(0xd0, 0x84, 0xc0),
-	float4_rgb(0xdc, 0x9c, 0xd0),
-	float4_rgb(0xec, 0xb0, 0xe0),
-	float4_rgb(0x48, 0x00, 0x78),
-	float4_rgb(0x60, 0x20, 0x90),
-	float4_rgb(0x78, 0x3c, 0xa4),
-	float4_rgb(0x8c, 0x58, 0xb8),
-	float4_rgb(0xa0, 0x70, 0xcc),
-	float4_rgb(0xb4, 0x84, 0xdc),
-	float4_rgb(0xc4, 0x9c, 0xec),
-	float4_rgb(0xd4, 0xb0, 0xfc),
-	float4_rgb(0x14, 0x00, 0x84),
-	float4_rgb(0x30, 0x20, 0x98),
-	float4_rgb(0x4c, 0x3c, 0xac),
-	float4_rgb(0x68, 0x58, 0xc0),
-	float4_rgb(0x7c, 0x70, 0xd0),
-	float4_rgb(0x94, 0x88, 0xe0),
-	float4_rgb(0xa8, 0xa0, 0xec),
-	float4_rgb(0xbc, 0xb4, 0xfc),
-	float4_rgb(0x00, 0x00, 0x88),
-	float4_rgb(0x1c, 0x20, 0x9c),
-	float4_rgb(0x38, 0x40, 0xb0),
-	float4_rgb(0x50, 0x5c, 0xc0),
-	float4_rgb(0x68, 0x74, 0xd0),
-	float4_rgb(0x7c, 0x8c, 0xe0),
-	float4_rgb(0x90, 0xa4, 0xec),
-	float4_rgb(0xa4, 0xb8, 0xfc),
-	float4_rgb(0x00, 0x18, 0x7c),
-	float4_rgb(0x1c, 0x38, 0x90),
-	float4_rgb(0x38, 0x54, 0xa8),
-	float4_rgb(0x50, 0x70, 0xbc),
-	float4_rgb(0x68, 0x88, 0xcc),
-	float4_rgb(0x7c, 0x9c, 0xdc),
-	float4_rgb(0x90, 0xb4, 0xec),
-	float4_rgb(0xa4, 0xc8, 0xfc),
-	float4_rgb(0x00, 0x2c, 0x5c),
-	float4_rgb(0x1c, 0x4c, 0x78),
-	float4_rgb(0x38, 0x68, 0x90),
-	float4_rgb(0x50, 0x84, 0xac),
-	float4_rgb(0x68, 0x9c, 0xc0),
-	float4_rgb(0x7c, 0xb4, 0xd4),
-	float4_rgb(0x90, 0xcc, 0xe8),
-	float4_rgb(0xa4, 0xe0, 0xfc),
-	float4_rgb(0x00, 0x3c, 0x2c),
-	float4_rgb(0x1c, 0x5c, 0x48),
-	float4_rgb(0x38, 0x7c, 0x64),
-	float4_rgb(0x50, 0x9c, 0x80),
-	float4_rgb(0x68, 0xb4, 0x94),
-	float4_rgb(0x7c, 0xd0, 0xac),
-	float4_rgb(0x90, 0xe4, 0xc0),
-	float4_rgb(0xa4, 0xfc, 0xd4),
-	float4_rgb(0x00, 0x3c, 0x00),
-	float4_rgb(0x20, 0x5c, 0x20),
-	float4_rgb(0x40, 0x7c, 0x40),
-	float4_rgb(0x5c, 0x9c, 0x5c),
-	float4_rgb(0x74, 0xb4, 0x74),
-	float4_rgb(0x8c, 0xd0, 0x8c),
-	float4_rgb(0xa4, 0xe4, 0xa4),
-	float4_rgb(0xb8, 0xfc, 0xb8),
-	float4_rgb(0x14, 0x38, 0x00),
-	float4_rgb(0x34, 0x5c, 0x1c),
-	float4_rgb(0x50, 0x7c, 0x38),
-	float4_rgb(0x6c, 0x98, 0x50),
-	float4_rgb(0x84, 0xb4, 0x68),
-	float4_rgb(0x9c, 0xcc, 0x7c),
-	float4_rgb(0xb4, 0xe4, 0x90),
-	float4_rgb(0xc8, 0xfc, 0xa4),
-	float4_rgb(0x2c, 0x30, 0x00),
-	float4_rgb(0x4c, 0x50, 0x1c),
-	float4_rgb(0x68, 0x70, 0x34),
-	float4_rgb(0x84, 0x8c, 0x4c),
-	float4_rgb(0x9c, 0xa8, 0x64),
-	float4_rgb(0xb4, 0xc0, 0x78),
-	float4_rgb(0xcc, 0xd4, 0x88),
-	float4_rgb(0xe0, 0xec, 0x9c),
-	float4_rgb(0x44, 0x28, 0x00),
-	float4_rgb(0x64, 0x48, 0x18),
-	float4_rgb(0x84, 0x68, 0x30),
-	float4_rgb(0xa0, 0x84, 0x44),
-	float4_rgb(0xb8, 0x9c, 0x58),
-	float4_rgb(0xd0, 0xb4, 0x6c),
-	float4_rgb(0xe8, 0xcc, 0x7c),
-	float4_rgb(0xfc, 0xe0, 0x8c)
+	NTSC_PALETTE(float4_rgb)
 };
 
 #endif /* ntsc_palette_h */
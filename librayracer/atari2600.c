@@ -7,40 +7,232 @@
 
 #include "atari2600.h"
 #include "graphics.h"
+#include "recompiler.h"
+#include "translator.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+
+
+// MARK: -
+// MARK: Peripheral clock synchronization
+
+/// Advances TIA clock to the current MPU cycle.
+static inline void sync_tia(racer_atari2600 *console) {
+	if (console->tia_lag > 0) {
+		racer_tia_advance_clocks(console->tia, console->tia_lag * 3);
+		console->tia_lag = 0;
+	}
+}
+
+/// Advances RIOT clock to the cycle preceding the current MPU cycle.
+///
+/// NOTE: RIOT clock advances after MPU clock in every cycle, so it must
+/// lag by 1 cycle, when MPU accesses it.
+static inline void sync_riot(racer_atari2600 *console) {
+	if (console->riot_lag > 1) {
+		racer_mcs6532_advance_clocks(console->riot, console->riot_lag - 1);
+		console->riot_lag = 1;
+	}
+}
+
+/// Advances TIA and RIOT clocks to the end of the current MPU cycle.
+static void sync_peripherals(racer_atari2600 *console) {
+	sync_tia(console);
+	racer_mcs6532_advance_clocks(console->riot, console->riot_lag);
+	console->riot_lag = 0;
+}
 
 
 // MARK: -
 // MARK: Bus
-static uint8_t read_bus(void *bus, int address) {
+
+/// Returns index of the selected bank of the inserted cartridge.
+static const int *get_bank_index(const racer_atari2600 *console) {
+	// single-bank cartridges always have bank 0 selected
+	static const int single_bank_index = 0;
+	
+	switch (console->cartridge_type) {
+		case CARTRIDGE_ATARI_8KB:
+		case CARTRIDGE_ATARI_12KB:
+		case CARTRIDGE_ATARI_16KB:
+		case CARTRIDGE_ATARI_32KB:
+			return &((atari_multi_bank_cartridge *)console->cartridge)->bank_index;
+		default:
+			return &single_bank_index;
+	}
+}
+
+/// Maps pages of cartridge ROM to the selected bank of the inserted cartridge; unmaps them, when no
+/// cartridge is inserted.
+///
+/// Pages overlapping bank switching address range are never mapped, so that accessing them is
+/// handled and switches banks.
+static void map_cartridge_pages(racer_atari2600 *console) {
+	// 2KB cartridges mirror their only bank, and do not switch banks
+	const int bank_switch_address = (console->cartridge_type == CARTRIDGE_ATARI_2KB)
+	? 0x1000
+	: racer_cartridge_get_bank_switch_address(console->cartridge_type);
+	
+	for (int address = 0x000; address < 0x1000; address += 0x40) {
+		racer_atari2600_page *page = &console->pages[(0x1000 | address) >> 6];
+		if (console->program != NULL && address + 0x40 <= bank_switch_address) {
+			page->read_memory = console->program->data + console->map_cartridge(console->cartridge, address);
+		} else {
+			page->read_memory = NULL;
+		}
+	}
+}
+
+static uint8_t read_riot_page(void *bus, int address) {
 	racer_atari2600 *console = (racer_atari2600 *)bus;
-	if (address & 0x1000) {
-		return console->read_cartridge(console->cartridge, address & 0xfff);
-	} else if ((address & 0x280) == 0x280) {
-		return racer_mcs6532_read(console->riot, address & 0x1f);
-	} else if ((address & 0x80) == 0x80) {
-		return console->riot->memory[address & 0x7f];
-	} else {
-		return racer_tia_read(console->tia, address & 0x3f);
+	sync_tia(console);
+	sync_riot(console);
+	return racer_mcs6532_read(console->riot, address & 0x1f);
+}
+
+static void write_riot_page(void *bus, int address, uint8_t data) {
+	racer_atari2600 *console = (racer_atari2600 *)bus;
+	sync_tia(console);
+	sync_riot(console);
+	racer_mcs6532_write(console->riot, address & 0x1f, data);
+}
+
+static uint8_t read_tia_page(void *bus, int address) {
+	racer_atari2600 *console = (racer_atari2600 *)bus;
+	sync_tia(console);
+	sync_riot(console);
+	return racer_tia_read(console->tia, address & 0x3f);
+}
+
+static void write_tia_page(void *bus, int address, uint8_t data) {
+	racer_atari2600 *console = (racer_atari2600 *)bus;
+	sync_tia(console);
+	sync_riot(console);
+	racer_tia_write(console->tia, address & 0x3f, data);
+}
+
+static uint8_t read_cartridge_page(void *bus, int address) {
+	racer_atari2600 *console = (racer_atari2600 *)bus;
+	const int bank_index = *get_bank_index(console);
+	const uint8_t data = console->read_cartridge(console->cartridge, address & 0xfff);
+	
+	if (*get_bank_index(console) != bank_index) {
+		map_cartridge_pages(console);
 	}
+	return data;
 }
 
-static void write_bus(void *bus, int address, uint8_t data) {
+static void write_cartridge_page(void *bus, int address, uint8_t data) {
 	racer_atari2600 *console = (racer_atari2600 *)bus;
-	if ((address & 0xf000) == 0xf000) {
-		console->write_cartridge(console->cartridge, address & 0xfff, data);
-	} else if ((address & 0x280) == 0x280) {
-		racer_mcs6532_write(console->riot, address & 0x1f, data);
-	} else if ((address & 0x80) == 0x80) {
-		console->riot->memory[address & 0x7f] = data;
+	const int bank_index = *get_bank_index(console);
+	console->write_cartridge(console->cartridge, address & 0xfff, data);
+	
+	if (*get_bank_index(console) != bank_index) {
+		map_cartridge_pages(console);
+	}
+}
+
+/// Maps all pages of MPU address space, except for those of cartridge ROM, which are mapped when
+/// cartridge is inserted.
+static void map_pages(racer_atari2600 *console) {
+	for (int index = 0; index < ATARI2600_PAGE_COUNT; ++index) {
+		const int address = index << 6;
+		racer_atari2600_page *page = &console->pages[index];
+		
+		if (address & 0x1000) {
+			*page = (racer_atari2600_page){NULL, NULL, read_cartridge_page, write_cartridge_page};
+		} else if ((address & 0x280) == 0x280) {
+			*page = (racer_atari2600_page){NULL, NULL, read_riot_page, write_riot_page};
+		} else if ((address & 0x80) == 0x80) {
+			uint8_t *memory = console->riot->memory + (address & 0x40);
+			*page = (racer_atari2600_page){memory, memory, NULL, NULL};
+		} else {
+			*page = (racer_atari2600_page){NULL, NULL, read_tia_page, write_tia_page};
+		}
+	}
+}
+
+static inline uint8_t read_memory(racer_atari2600 *console, int address) {
+	const racer_atari2600_page *page = &console->pages[(address >> 6) & (ATARI2600_PAGE_COUNT - 1)];
+	return (page->read_memory != NULL)
+	? page->read_memory[address & 0x3f]
+	: page->read(console, address);
+}
+
+static inline void write_memory(racer_atari2600 *console, int address, uint8_t data) {
+	const racer_atari2600_page *page = &console->pages[(address >> 6) & (ATARI2600_PAGE_COUNT - 1)];
+	if (page->write_memory != NULL) {
+		page->write_memory[address & 0x3f] = data;
 	} else {
-		racer_tia_write(console->tia, address & 0x3f, data);
+		page->write(console, address, data);
 	}
 }
 
+static uint8_t read_bus(void *bus, int address) {
+	return read_memory((racer_atari2600 *)bus, address);
+}
+
+static void write_bus(void *bus, int address, uint8_t data) {
+	write_memory((racer_atari2600 *)bus, address, data);
+}
+
+/// Returns offset in cartridge program of the operation at the specified address; -1 when it is not
+/// in cartridge ROM.
+static inline int get_predecoded_offset(const racer_atari2600 *console, int address) {
+	return (address & 0x1000) && console->program != NULL
+	? console->map_cartridge(console->cartridge, address & 0xfff)
+	: -1;
+}
+
+static inline const predecoded *get_predecoded(const racer_atari2600 *console, int offset) {
+	if (offset < 0) {
+		return NULL;
+	}
+	
+	const predecoded *operation = &console->program->operations[offset];
+	return (operation->length > 0) ? operation : NULL;
+}
+
+static const predecoded *read_predecoded(void *bus, int address) {
+	// only operations in cartridge ROM are predecoded; operations in RAM
+	// are always decoded from the bus
+	racer_atari2600 *console = (racer_atari2600 *)bus;
+	return get_predecoded(console, get_predecoded_offset(console, address));
+}
+
+// bus accesses of the differential engine are also recorded, to verify
+// compiled code against; MPU is wired to these with that engine only
+static uint8_t read_recorded_bus(void *bus, int address) {
+	racer_atari2600 *console = (racer_atari2600 *)bus;
+	const uint8_t data = read_memory(console, address);
+	racer_recompiler_record_read(console->recompiler, address, data);
+	return data;
+}
+
+static void write_recorded_bus(void *bus, int address, uint8_t data) {
+	racer_atari2600 *console = (racer_atari2600 *)bus;
+	racer_recompiler_record_write(console->recompiler, address, data);
+	write_memory(console, address, data);
+}
+
+static const predecoded *read_recorded_predecoded(void *bus, int address) {
+	racer_atari2600 *console = (racer_atari2600 *)bus;
+	const int offset = get_predecoded_offset(console, address);
+	racer_recompiler_record_decode(console->recompiler, address, offset);
+	return get_predecoded(console, offset);
+}
+
+/// Wires MPU to the bus, which records accesses only for the differential engine with a recompiler,
+/// so that other engines do not check for it on every access.
+static void wire_bus(racer_atari2600 *console) {
+	const bool is_recorded = console->engine == ATARI2600_ENGINE_DIFFERENTIAL && console->recompiler != NULL;
+	console->mpu->read_bus = is_recorded ? read_recorded_bus : read_bus;
+	console->mpu->write_bus = is_recorded ? write_recorded_bus : write_bus;
+	console->mpu->read_predecoded = is_recorded ? read_recorded_predecoded : read_predecoded;
+}
 
 // MARK: -
 // MARK: MCS6532 and TIA peripherals
@@ -82,8 +274,6 @@ racer_atari2600 *racer_atari2600_create(void) {
 	// create and wire MPU
 	console->mpu = (racer_mcs6507 *)malloc(sizeof(racer_mcs6507));
 	console->mpu->bus = console;
-	console->mpu->read_bus = read_bus;
-	console->mpu->write_bus = write_bus;
 	
 	// create and wire RIOT
 	console->riot = (racer_mcs6532 *)malloc(sizeof(racer_mcs6532));
@@ -108,17 +298,44 @@ racer_atari2600 *racer_atari2600_create(void) {
 	console->tia->is_ready = &console->mpu->is_ready;
 	console->tia->peripheral = console;
 	console->tia->read_port = tia_read_controllers;
+	console->tia->render_mode = TIA_RENDER_FULL;
+	console->tia->next_render_mode = TIA_RENDER_FULL;
+	console->tia->layout = (racer_tia_layout){TIA_LAYOUT_FULL};
+	console->tia->next_layout = console->tia->layout;
+	console->tia->observation = NULL;
+	console->tia->line_buffer = NULL;
 	
-	console->tia->players[0].missile_position = &null_missile_position;
-	console->tia->players[1].missile_position = &null_missile_position;
+	console->tia->players[0].missile_position = &console->tia->null_missile_position;
+	console->tia->players[1].missile_position = &console->tia->null_missile_position;
+	
+	console->cartridge = NULL;
+	console->program = NULL;
+	console->tia_lag = 0;
+	console->riot_lag = 0;
+	console->idle_cycles = 0;
+	map_pages(console);
+	
+	console->engine = ATARI2600_ENGINE_INTERPRETER;
+	console->recompiler = NULL;
+	console->translation = NULL;
+	wire_bus(console);
 	
 	init_graphics();
 	return console;
 }
 
+void racer_atari2600_destroy(racer_atari2600 *console) {
+	racer_atari2600_remove_cartridge(console);
+	free(console->tia);
+	free(console->riot);
+	free(console->mpu);
+	free(console);
+}
+
 void racer_atari2600_reset(racer_atari2600 *console) {
 	// reset bank index in cartridge
 	racer_cartridge_reset(console->cartridge_type, console->cartridge);
+	map_cartridge_pages(console);
 	// reset controller input
 	console->switches[0] = 0x00;
 	console->input = 0x00;
@@ -145,7 +362,194 @@ void racer_atari2600_advance_clock(racer_atari2600 *console) {
 	racer_mcs6532_advance_clock(console->riot);
 }
 
+/// Skips whole iterations of the polling loop starting at the current MPU operation, when it polls RIOT
+/// timer or interrupt flag, but no longer than the specified number of cycles and the end of the
+/// current scan line.
+///
+/// Polled data only changes as RIOT timer counts down, and iterations, which read the same data,
+/// leave MPU in the same state; such iterations are skipped at once, until one exits the loop. TIA
+/// clock is advanced by the skipped cycles in bulk.
+/// Returns the number of skipped cycles.
+static int skip_polling_loop(racer_atari2600 *console, int cycles) {
+	racer_mcs6507 *mpu = console->mpu;
+	if (!mpu->is_ready || (mpu->operation.address & 0x1280) != 0x280) {
+		return 0;
+	}
+	
+	racer_mcs6507_polling_loop loop;
+	if (!racer_mcs6507_get_polling_loop(mpu, &loop)
+		|| (loop.address & 0x1280) != 0x280
+		|| (loop.address & 0x6) != 0x4) {
+		return 0;
+	}
+	
+	// NOTE: polled data may never change (e.g. once RIOT timer stops), so
+	// skipping stops at the end of scan line, which lets TIA reach its next
+	// sync, and keeps skipped cycles well within int range
+	const int line_cycles = racer_tia_get_wsync_cycles(console->tia);
+	cycles = (line_cycles < cycles) ? line_cycles : cycles;
+	
+	int count = 0;
+	while (loop.duration <= cycles - count) {
+		// NOTE: RIOT clock lags by 1 cycle, when MPU reads it
+		racer_mcs6532 riot = *console->riot;
+		racer_mcs6532_advance_clocks(&riot, loop.read_cycle - 1);
+		
+		// following iterations, which read the same data, repeat the same;
+		// steady cycles are taken before reading, which may change the data
+		// read next (e.g. clear edge detect interrupt flag)
+		const int steady_cycles = racer_mcs6532_get_steady_cycles(&riot, loop.address);
+		const uint8_t data = racer_mcs6532_read(&riot, loop.address);
+		
+		if (!racer_mcs6507_repeat_polling_loop(mpu, &loop, data)) {
+			break;
+		}
+		const int remaining_count = (cycles - count) / loop.duration;
+		const int iteration_count = (steady_cycles / loop.duration < remaining_count - 1)
+		? steady_cycles / loop.duration + 1
+		: remaining_count;
+		
+		racer_mcs6532_advance_clocks(&riot, iteration_count * loop.duration - loop.read_cycle + 1);
+		*console->riot = riot;
+		count += iteration_count * loop.duration;
+	}
+	
+	if (count > 0) {
+		racer_tia_advance_clocks(console->tia, count * 3);
+		console->idle_cycles += count;
+	}
+	return count;
+}
+
+/// Returns translated block, which starts at the specified predecoded operation; `NULL` when there is
+/// none, or the operation is outside cartridge ROM.
+static racer_translated_block get_translated_block(const racer_atari2600 *console, const predecoded *operation) {
+	return (operation != NULL && console->translation != NULL)
+	? console->translation->blocks[operation - console->program->operations]
+	: NULL;
+}
+
+/// Runs the basic block of operations starting at the current MPU operation, but no longer than
+/// the specified number of cycles.
+///
+/// Returns the number of advanced cycles.
+static int run_block(racer_atari2600 *console, int cycles) {
+	racer_mcs6507 *mpu = console->mpu;
+	
+	// skip iterations of a loop, in which MPU idles polling RIOT timer
+	const int idle_cycles = skip_polling_loop(console, cycles);
+	if (idle_cycles > 0) {
+		return idle_cycles;
+	}
+	
+	// operations outside cartridge ROM make up a block of their own
+	const predecoded *operation = mpu->read_predecoded(console, mpu->program_counter);
+	int block_length = (operation != NULL) ? operation->block_length : 1;
+	
+	// run translated block, when there is one; differential engine verifies
+	// it against the interpreter, same as a compiled block
+	int count = 0;
+	const racer_translated_block block = get_translated_block(console, operation);
+	if (block != NULL && console->engine == ATARI2600_ENGINE_RECOMPILER) {
+		count = block(console, get_bank_index(console), cycles);
+		block_length = (count > 0) ? 0 : block_length;
+	} else if (block != NULL && console->engine == ATARI2600_ENGINE_DIFFERENTIAL && console->recompiler != NULL) {
+		count = racer_recompiler_run_translated_block(console->recompiler, console, block, cycles);
+		block_length = (count > 0) ? 0 : block_length;
+	}
+	
+	// otherwise, run compiled block, when there is one
+	if (count == 0 && operation != NULL && console->recompiler != NULL) {
+		const bool is_differential = console->engine == ATARI2600_ENGINE_DIFFERENTIAL;
+		count = racer_recompiler_run_block(console->recompiler, console, cycles, is_differential);
+		block_length = (count > 0) ? 0 : block_length;
+	}
+	
+	while (block_length > 0 && mpu->is_ready) {
+		const int remaining_cycles = mpu->operation.duration - mpu->operation_clock;
+		if (count + remaining_cycles > cycles) {
+			break;
+		}
+		
+		// NOTE: MPU only accesses TIA and RIOT on the last cycle of an
+		// operation; both lag behind until MPU accesses either of them or
+		// the block ends
+		console->tia_lag += remaining_cycles;
+		console->riot_lag += remaining_cycles;
+		racer_mcs6507_complete_operation(mpu);
+		
+		count += remaining_cycles;
+		block_length -= 1;
+	}
+	sync_peripherals(console);
+	
+	// MPU halted by WSYNC does not access the bus until TIA starts the next
+	// scan line; advance TIA and RIOT clocks to the cycle, in which it does,
+	// at once
+	if (count == 0 && !mpu->is_ready) {
+		const int wsync_cycles = racer_tia_get_wsync_cycles(console->tia);
+		count = (wsync_cycles < cycles) ? wsync_cycles : cycles;
+		
+		racer_tia_advance_clocks(console->tia, count * 3);
+		racer_mcs6532_advance_clocks(console->riot, count);
+	}
+	
+	// MPU starts counting cycles in the middle of the cycle, in which TIA
+	// releases RDY state; advance such cycle 1 at a time, same as the tail
+	// of an operation, which does not fit the specified cycles
+	if (count == 0) {
+		racer_atari2600_advance_clock(console);
+		count = 1;
+	}
+	
+	return count;
+}
+
+int racer_atari2600_run_cycles(racer_atari2600 *console, int cycles) {
+	int count = 0;
+	while (count < cycles) {
+		count += run_block(console, cycles - count);
+	}
+	
+	return count;
+}
+
+int racer_atari2600_run_frame(racer_atari2600 *console) {
+	const int field_count = console->tia->field_count;
+	
+	int count = 0;
+	while (console->tia->field_count == field_count) {
+		count += run_block(console, INT_MAX);
+	}
+	
+	return count;
+}
+
+/// Creates recompiler for the inserted cartridge.
+static racer_recompiler *create_recompiler(racer_atari2600 *console) {
+	return racer_recompiler_create(console->program, get_bank_index(console));
+}
+
+void racer_atari2600_set_engine(racer_atari2600 *console, racer_atari2600_engine engine) {
+	console->engine = engine;
+	
+	if (engine == ATARI2600_ENGINE_INTERPRETER) {
+		if (console->recompiler != NULL) {
+			racer_recompiler_destroy(console->recompiler);
+			console->recompiler = NULL;
+		}
+	} else if (console->recompiler == NULL && console->program != NULL) {
+		console->recompiler = create_recompiler(console);
+	}
+	wire_bus(console);
+}
+
+const char *racer_atari2600_get_engine_difference(const racer_atari2600 *console) {
+	return (console->recompiler != NULL) ? racer_recompiler_get_difference(console->recompiler) : NULL;
+}
+
 void racer_atari2600_insert_cartridge(racer_atari2600 *console, racer_cartridge_type type, const uint8_t *data) {
+	racer_atari2600_remove_cartridge(console);
 	console->cartridge_type = type;
 	
 	switch (type) {
@@ -153,67 +557,68 @@ void racer_atari2600_insert_cartridge(racer_atari2600 *console, racer_cartridge_
 			console->cartridge = (void *)data;
 			console->read_cartridge = read_atari_2kb_cartridge;
 			console->write_cartridge = write_atari_cartridge;
+			console->map_cartridge = map_atari_2kb_cartridge;
 			break;
-			
+		
 		case CARTRIDGE_ATARI_4KB:
 			console->cartridge = (void *)data;
 			console->read_cartridge = read_atari_4kb_cartridge;
 			console->write_cartridge = write_atari_cartridge;
+			console->map_cartridge = map_atari_4kb_cartridge;
 			break;
-			
+		
 		case CARTRIDGE_ATARI_8KB:
-			console->cartridge = &(atari_multi_bank_cartridge){
-				.bank_count = 8/4,
-				.bank_index = 0,
-				.bank_switch_address = 0xff8,
-				.data = data
-			};
-			console->read_cartridge = read_atari_multi_bank_cartridge;
-			console->write_cartridge = write_atari_multi_bank_cartridge;
-			break;
-			
 		case CARTRIDGE_ATARI_12KB:
-			console->cartridge = &(atari_multi_bank_cartridge){
-				.bank_count = 12/4,
-				.bank_index = 0,
-				.bank_switch_address = 0xff8,
-				.data = data
-			};
-			console->read_cartridge = read_atari_multi_bank_cartridge;
-			console->write_cartridge = write_atari_multi_bank_cartridge;
-			break;
-			
 		case CARTRIDGE_ATARI_16KB:
-			console->cartridge = &(atari_multi_bank_cartridge){
-				.bank_count = 16/4,
-				.bank_index = 0,
-				.bank_switch_address = 0xff6,
-				.data = data
-			};
-			console->read_cartridge = read_atari_multi_bank_cartridge;
-			console->write_cartridge = write_atari_multi_bank_cartridge;
-			break;
-			
 		case CARTRIDGE_ATARI_32KB:
-			console->cartridge = &(atari_multi_bank_cartridge){
-				.bank_count = 32/4,
-				.bank_index = 0,
-				.bank_switch_address = 0xff4,
-				.data = data
-			};
+			console->cartridge = create_atari_multi_bank_cartridge(type, data);
 			console->read_cartridge = read_atari_multi_bank_cartridge;
 			console->write_cartridge = write_atari_multi_bank_cartridge;
+			console->map_cartridge = map_atari_multi_bank_cartridge;
 			break;
-			
+		
 		default:
 			printf("%s: unsupport cartridge type: %d\n", __func__, type);
 			exit(EXIT_FAILURE);
 			break;
 	}
+	
+	console->program = racer_cartridge_retain_program(type, data);
+	map_cartridge_pages(console);
+	console->translation = racer_translator_find(console->program);
+	if (console->engine != ATARI2600_ENGINE_INTERPRETER) {
+		console->recompiler = create_recompiler(console);
+	}
+	wire_bus(console);
 }
 
 void racer_atari2600_remove_cartridge(racer_atari2600 *console) {
+	if (console->cartridge != NULL) {
+		switch (console->cartridge_type) {
+			case CARTRIDGE_ATARI_8KB:
+			case CARTRIDGE_ATARI_12KB:
+			case CARTRIDGE_ATARI_16KB:
+			case CARTRIDGE_ATARI_32KB:
+				free(console->cartridge);
+				break;
+			default:
+				break;
+		}
+	}
+	if (console->recompiler != NULL) {
+		racer_recompiler_destroy(console->recompiler);
+	}
+	if (console->program != NULL) {
+		racer_cartridge_release_program(console->program);
+	}
+	
 	console->cartridge = NULL;
 	console->read_cartridge = NULL;
 	console->write_cartridge = NULL;
+	console->map_cartridge = NULL;
+	console->program = NULL;
+	console->recompiler = NULL;
+	console->translation = NULL;
+	map_cartridge_pages(console);
+	wire_bus(console);
 }
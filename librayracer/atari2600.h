@@ -23,6 +23,35 @@ typedef enum {
 	ATARI2600_SWITCH_DIFFICULTY_1 = 1<<7
 } racer_atari2600_switch;
 
+/// Engines, which run MPU operations of cartridge code.
+typedef enum {
+	/// Interprets cartridge code.
+	ATARI2600_ENGINE_INTERPRETER,
+	/// Runs cartridge code translated ahead of time, when such translation is linked, and hot basic
+	/// blocks of cartridge code compiled into native code; interprets the rest.
+	ATARI2600_ENGINE_RECOMPILER,
+	/// Runs translated and compiled basic blocks same as the recompiler, verifying each one against
+	/// the interpreter.
+	ATARI2600_ENGINE_DIFFERENTIAL
+} racer_atari2600_engine;
+
+/// The number of pages in MPU address space.
+#define ATARI2600_PAGE_COUNT 0x80
+
+/// A 64-byte page of MPU address space.
+///
+/// Pages backed by plain memory are accessed directly through their memory pointers. Pages, accessing
+/// which has side effects (i.e. TIA and RIOT registers and cartridge bank switching), have `NULL`
+/// memory pointers and are accessed through their handlers instead. ROM pages are read-only, and
+/// writes to them are always handled.
+typedef struct {
+	const uint8_t *read_memory;
+	uint8_t *write_memory;
+	
+	uint8_t (*read)(void *bus, int address);
+	void (*write)(void *bus, int address, uint8_t data);
+} racer_atari2600_page;
+
 typedef struct {
 	racer_mcs6507 *mpu;
 	racer_mcs6532 *riot;
@@ -35,12 +64,58 @@ typedef struct {
 	void *cartridge;
 	uint8_t (*read_cartridge)(void *cartridge, int address);
 	void (*write_cartridge)(void *cartridge, int address, uint8_t data);
+	int (*map_cartridge)(const void *cartridge, int address);
+	const racer_cartridge_program *program;
+	
+	// pages of MPU address space, indexed by bits 6-12 of address; pages
+	// of cartridge ROM are remapped, whenever cartridge switches banks
+	racer_atari2600_page pages[ATARI2600_PAGE_COUNT];
+	
+	// the number of MPU cycles TIA and RIOT clocks lag behind MPU clock,
+	// while running basic blocks of operations
+	int tia_lag;
+	int riot_lag;
+	
+	// the number of MPU cycles skipped in loops polling RIOT timer
+	uint64_t idle_cycles;
+	
+	racer_atari2600_engine engine;
+	struct racer_recompiler *recompiler;
+	const struct racer_translation *translation;
 } racer_atari2600;
 
 racer_atari2600 *racer_atari2600_create(void);
+
+/// Destroys the specified console, removing its cartridge first.
+void racer_atari2600_destroy(racer_atari2600 *console);
+
 void racer_atari2600_reset(racer_atari2600 *console);
 void racer_atari2600_advance_clock(racer_atari2600 *console);
 
+/// Advances console clock by the specified number of MPU cycles.
+///
+/// Whole basic blocks of cartridge operations are executed at once; TIA and RIOT clocks are advanced
+/// in bulk, only when MPU accesses either of them and at the end of each block. The result is
+/// identical to advancing console clock 1 cycle at a time.
+/// Returns the number of advanced cycles, which always equals the specified one.
+int racer_atari2600_run_cycles(racer_atari2600 *console, int cycles);
+
+/// Advances console clock until TIA starts vertical sync or fills video buffer, completing the basic
+/// block during which this happens.
+///
+/// Returns the number of advanced MPU cycles.
+int racer_atari2600_run_frame(racer_atari2600 *console);
+
+/// Selects engine, which runs MPU operations of cartridge code.
+///
+/// Engine only affects running operations in bulk (i.e. `racer_atari2600_run_cycles` and
+/// `racer_atari2600_run_frame`); the result is identical with any engine.
+void racer_atari2600_set_engine(racer_atari2600 *console, racer_atari2600_engine engine);
+
+/// Returns description of the first difference between compiled and interpreted code found by
+/// differential engine; `NULL` when there is none.
+const char *racer_atari2600_get_engine_difference(const racer_atari2600 *console);
+
 void racer_atari2600_insert_cartridge(racer_atari2600 *console, racer_cartridge_type type, const uint8_t *data);
 void racer_atari2600_remove_cartridge(racer_atari2600 *console);
 
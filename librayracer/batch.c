@@ -0,0 +1,356 @@
+//
+//  batch.c
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#include "batch.h"
+#include "controller.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+
+/// Console of a batch, along with the buffer, which it draws into after its frame ends, until the
+/// next step.
+typedef struct {
+	racer_atari2600 *console;
+	
+	uint8_t *spill_buffer;
+	size_t spill_size;
+	bool is_spilled;
+} batch_console;
+
+/// Worker thread of a batch, aligned to a cache line, since its deque is accessed by all workers.
+typedef struct {
+	_Alignas(64) struct racer_batch *batch;
+	int index;
+	
+	/// Deque of consoles, which the worker runs frames of in the current step: a contiguous range of
+	/// console indices, its start in the lower 32 bits and end in the upper 32 bits; the worker takes
+	/// consoles from its start, and other workers steal them from its end.
+	_Atomic uint64_t range;
+	
+	/// Statistics since they were last reset; busy time is in nanoseconds.
+	long frame_count;
+	long steal_count;
+	int64_t busy_time;
+} batch_worker;
+
+struct racer_batch {
+	batch_console *consoles;
+	int console_count;
+	
+	// worker 0 is the thread stepping the batch, the rest are pooled
+	batch_worker *workers;
+	pthread_t *threads;
+	int thread_count;
+	
+	// workers wait for step index to change, and the stepping thread
+	// waits for all of them to complete it
+	pthread_mutex_t mutex;
+	pthread_cond_t start;
+	pthread_cond_t finish;
+	long step_index;
+	int pending_count;
+	bool is_stopped;
+	
+	// total duration of steps since worker statistics were last reset,
+	// in nanoseconds
+	int64_t step_time;
+	
+	// arguments of the current step
+	const uint8_t *inputs;
+	uint8_t *frames;
+	size_t frame_size;
+};
+
+
+// MARK: -
+// MARK: Frames
+
+static void sync_video(const void *output, racer_video_sync sync) {
+	if (!(sync & (VIDEO_VERTICAL_SYNC | VIDEO_BUFFER_SYNC))) {
+		return;
+	}
+	
+	// frame is complete; keep drawing into spill buffer until the end
+	// of the current basic block
+	batch_console *entry = (batch_console *)output;
+	racer_tia *tia = entry->console->tia;
+	tia->video_buffer = entry->spill_buffer;
+	tia->video_buffer_end = entry->spill_buffer + entry->spill_size;
+	entry->is_spilled = true;
+}
+
+/// Runs a single frame of console at the specified index, in the current step of the specified batch.
+static void run_console(racer_batch *batch, int index) {
+	batch_console *entry = &batch->consoles[index];
+	racer_atari2600 *console = entry->console;
+	if (console->program == NULL) {
+		return;
+	}
+	if (batch->inputs != NULL) {
+		racer_joysticks_write_output(console, batch->inputs + 2 * index);
+	}
+	
+	// spill buffer matches the size of a frame; whatever spilled into
+	// the previous one is dropped, when frame size changes
+	if (entry->spill_size != batch->frame_size) {
+		free(entry->spill_buffer);
+		entry->spill_buffer = (uint8_t *)malloc(batch->frame_size);
+		entry->spill_size = batch->frame_size;
+		entry->is_spilled = false;
+	}
+	
+	// open frame with color clocks spilled at the end of the previous one
+	racer_tia *tia = console->tia;
+	uint8_t *frame = batch->frames + index * batch->frame_size;
+	size_t spilled_size = 0;
+	if (entry->is_spilled) {
+		spilled_size = tia->video_buffer - entry->spill_buffer;
+		memcpy(frame, entry->spill_buffer, spilled_size);
+		tia->line_buffer = frame + (tia->line_buffer - entry->spill_buffer);
+		entry->is_spilled = false;
+	}
+	tia->video_buffer = frame + spilled_size;
+	tia->video_buffer_end = frame + batch->frame_size;
+	
+	racer_atari2600_run_frame(console);
+}
+
+/// Returns current time of monotonic clock in nanoseconds.
+static int64_t get_time(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+static inline uint64_t make_range(uint32_t start, uint32_t end) {
+	return (uint64_t)end << 32 | start;
+}
+
+/// Takes the next console off the start of deque of the specified worker; returns -1 when its deque
+/// is empty.
+static int take_console(batch_worker *worker) {
+	uint64_t range = atomic_load_explicit(&worker->range, memory_order_relaxed);
+	while (true) {
+		const uint32_t start = (uint32_t)range;
+		const uint32_t end = (uint32_t)(range >> 32);
+		if (start >= end) {
+			return -1;
+		}
+		if (atomic_compare_exchange_weak_explicit(&worker->range, &range, make_range(start + 1, end), memory_order_acquire, memory_order_relaxed)) {
+			return start;
+		}
+	}
+}
+
+/// Steals the latter half of consoles off the end of deque of any other worker into the empty deque of
+/// the specified one; returns whether there were any consoles left to steal.
+static bool steal_consoles(racer_batch *batch, batch_worker *thief) {
+	for (int offset = 1; offset < batch->thread_count; ++offset) {
+		batch_worker *victim = &batch->workers[(thief->index + offset) % batch->thread_count];
+		uint64_t range = atomic_load_explicit(&victim->range, memory_order_relaxed);
+		while (true) {
+			const uint32_t start = (uint32_t)range;
+			const uint32_t end = (uint32_t)(range >> 32);
+			if (start >= end) {
+				break;
+			}
+			
+			// the last console can be stolen too, so that a worker running
+			// a slow frame never holds up the next one
+			const uint32_t middle = end - (end - start + 1) / 2;
+			if (atomic_compare_exchange_weak_explicit(&victim->range, &range, make_range(start, middle), memory_order_acquire, memory_order_relaxed)) {
+				atomic_store_explicit(&thief->range, make_range(middle, end), memory_order_relaxed);
+				thief->steal_count += 1;
+				return true;
+			}
+		}
+	}
+	
+	return false;
+}
+
+/// Runs a single frame of every console in deque of the specified worker in the current step of
+/// the specified batch, stealing consoles of other workers once it is empty, until there are none
+/// left in any deque.
+static void run_partition(racer_batch *batch, int worker_index) {
+	batch_worker *worker = &batch->workers[worker_index];
+	do {
+		int index;
+		while ((index = take_console(worker)) >= 0) {
+			const int64_t start_time = get_time();
+			run_console(batch, index);
+			worker->busy_time += get_time() - start_time;
+			worker->frame_count += 1;
+		}
+	} while (steal_consoles(batch, worker));
+}
+
+
+// MARK: -
+// MARK: Worker pool
+
+static void *run_worker(void *data) {
+	batch_worker *worker = (batch_worker *)data;
+	racer_batch *batch = worker->batch;
+	long step_index = 0;
+	
+	pthread_mutex_lock(&batch->mutex);
+	while (true) {
+		while (batch->step_index == step_index && !batch->is_stopped) {
+			pthread_cond_wait(&batch->start, &batch->mutex);
+		}
+		if (batch->is_stopped) {
+			break;
+		}
+		step_index = batch->step_index;
+		
+		pthread_mutex_unlock(&batch->mutex);
+		run_partition(batch, worker->index);
+		pthread_mutex_lock(&batch->mutex);
+		
+		batch->pending_count -= 1;
+		if (batch->pending_count == 0) {
+			pthread_cond_signal(&batch->finish);
+		}
+	}
+	pthread_mutex_unlock(&batch->mutex);
+	
+	return NULL;
+}
+
+racer_batch *racer_batch_create(int console_count, int thread_count) {
+	racer_batch *batch = (racer_batch *)malloc(sizeof(racer_batch));
+	batch->console_count = console_count;
+	batch->consoles = (batch_console *)malloc(sizeof(batch_console) * console_count);
+	for (int index = 0; index < console_count; ++index) {
+		batch_console *entry = &batch->consoles[index];
+		entry->console = racer_atari2600_create();
+		entry->console->tia->video_output = entry;
+		entry->console->tia->sync_video = sync_video;
+		entry->spill_buffer = NULL;
+		entry->spill_size = 0;
+		entry->is_spilled = false;
+	}
+	
+	pthread_mutex_init(&batch->mutex, NULL);
+	pthread_cond_init(&batch->start, NULL);
+	pthread_cond_init(&batch->finish, NULL);
+	batch->step_index = 0;
+	batch->pending_count = 0;
+	batch->is_stopped = false;
+	batch->step_time = 0;
+	
+	batch->thread_count = (thread_count > 1) ? thread_count : 1;
+	batch->workers = (batch_worker *)aligned_alloc(_Alignof(batch_worker), sizeof(batch_worker) * batch->thread_count);
+	batch->threads = (pthread_t *)malloc(sizeof(pthread_t) * batch->thread_count);
+	for (int index = 0; index < batch->thread_count; ++index) {
+		batch_worker *worker = &batch->workers[index];
+		worker->batch = batch;
+		worker->index = index;
+		atomic_store_explicit(&worker->range, 0, memory_order_relaxed);
+		worker->frame_count = 0;
+		worker->steal_count = 0;
+		worker->busy_time = 0;
+		if (index > 0) {
+			pthread_create(&batch->threads[index], NULL, run_worker, worker);
+		}
+	}
+	
+	return batch;
+}
+
+void racer_batch_destroy(racer_batch *batch) {
+	// notify workers to break and wait for them to stop
+	pthread_mutex_lock(&batch->mutex);
+	batch->is_stopped = true;
+	pthread_cond_broadcast(&batch->start);
+	pthread_mutex_unlock(&batch->mutex);
+	for (int index = 1; index < batch->thread_count; ++index) {
+		pthread_join(batch->threads[index], NULL);
+	}
+	
+	for (int index = 0; index < batch->console_count; ++index) {
+		racer_atari2600_destroy(batch->consoles[index].console);
+		free(batch->consoles[index].spill_buffer);
+	}
+	
+	pthread_mutex_destroy(&batch->mutex);
+	pthread_cond_destroy(&batch->start);
+	pthread_cond_destroy(&batch->finish);
+	free(batch->consoles);
+	free(batch->workers);
+	free(batch->threads);
+	free(batch);
+}
+
+int racer_batch_get_console_count(const racer_batch *batch) {
+	return batch->console_count;
+}
+
+racer_atari2600 *racer_batch_get_console(racer_batch *batch, int index) {
+	return batch->consoles[index].console;
+}
+
+int racer_batch_get_thread_count(const racer_batch *batch) {
+	return batch->thread_count;
+}
+
+racer_batch_worker_stats racer_batch_get_worker_stats(const racer_batch *batch, int index) {
+	const batch_worker *worker = &batch->workers[index];
+	return (racer_batch_worker_stats){
+		.frame_count = worker->frame_count,
+		.steal_count = worker->steal_count,
+		.utilization = (batch->step_time > 0) ? (double)worker->busy_time / (double)batch->step_time : 0.0
+	};
+}
+
+void racer_batch_reset_worker_stats(racer_batch *batch) {
+	for (int index = 0; index < batch->thread_count; ++index) {
+		batch->workers[index].frame_count = 0;
+		batch->workers[index].steal_count = 0;
+		batch->workers[index].busy_time = 0;
+	}
+	batch->step_time = 0;
+}
+
+
+// MARK: -
+void racer_batch_step(racer_batch *batch, const uint8_t *inputs, uint8_t *frames, size_t frame_size) {
+	const int64_t start_time = get_time();
+	
+	// deal consoles out evenly in contiguous ranges, one per worker
+	for (int index = 0; index < batch->thread_count; ++index) {
+		const uint32_t start = index * batch->console_count / batch->thread_count;
+		const uint32_t end = (index + 1) * batch->console_count / batch->thread_count;
+		atomic_store_explicit(&batch->workers[index].range, make_range(start, end), memory_order_relaxed);
+	}
+	
+	// start the step on all pooled workers
+	pthread_mutex_lock(&batch->mutex);
+	batch->inputs = inputs;
+	batch->frames = frames;
+	batch->frame_size = frame_size;
+	batch->step_index += 1;
+	batch->pending_count = batch->thread_count - 1;
+	pthread_cond_broadcast(&batch->start);
+	pthread_mutex_unlock(&batch->mutex);
+	
+	// run partition of the stepping thread, then wait for the rest
+	run_partition(batch, 0);
+	
+	pthread_mutex_lock(&batch->mutex);
+	while (batch->pending_count > 0) {
+		pthread_cond_wait(&batch->finish, &batch->mutex);
+	}
+	pthread_mutex_unlock(&batch->mutex);
+	
+	batch->step_time += get_time() - start_time;
+}
@@ -0,0 +1,75 @@
+//
+//  batch.h
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#ifndef batch_h
+#define batch_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atari2600.h"
+
+/// Batch of independent consoles, which run frames in parallel on a fixed pool of threads, without
+/// any video output of their own.
+///
+/// Consoles are created along with the batch, and are otherwise set up by the caller (i.e. cartridges
+/// inserted, engine, TIA layout and render mode selected, and reset) between steps; their video
+/// output belongs to the batch.
+typedef struct racer_batch racer_batch;
+
+/// Creates batch of the specified number of consoles, which run on the specified number of threads,
+/// including the one stepping the batch.
+racer_batch *racer_batch_create(int console_count, int thread_count);
+
+/// Destroys the specified batch, its threads and all of its consoles.
+void racer_batch_destroy(racer_batch *batch);
+
+/// Returns the number of consoles in the specified batch.
+int racer_batch_get_console_count(const racer_batch *batch);
+
+/// Returns console at the specified index of the specified batch.
+racer_atari2600 *racer_batch_get_console(racer_batch *batch, int index);
+
+/// Returns the number of worker threads of the specified batch, including the one stepping it.
+int racer_batch_get_thread_count(const racer_batch *batch);
+
+/// Statistics of a worker thread of a batch, since they were last reset.
+typedef struct {
+	/// The number of console frames the worker ran.
+	long frame_count;
+	
+	/// The number of times the worker stole consoles from another one.
+	long steal_count;
+	
+	/// Fraction of the total duration of steps, which the worker spent running frames.
+	double utilization;
+} racer_batch_worker_stats;
+
+/// Returns statistics of worker thread at the specified index of the specified batch; worker 0 is
+/// the thread stepping the batch.
+///
+/// Statistics must only be read and reset between steps.
+racer_batch_worker_stats racer_batch_get_worker_stats(const racer_batch *batch, int index);
+
+/// Resets statistics of all worker threads of the specified batch.
+void racer_batch_reset_worker_stats(racer_batch *batch);
+
+/// Runs a single frame of every console in the specified batch, i.e. until its TIA starts vertical
+/// sync or fills video buffer, and returns once all of them complete.
+///
+/// Joystick buttons of each console are first set from the specified inputs, 2 bytes per console
+/// (same as with `racer_joysticks_write_output`), unless they are `NULL`. Each console draws into its
+/// own slot of the specified frames, of the specified size each, which must not change between
+/// steps. Color clocks, which a console draws past the end of its frame, before its current basic
+/// block completes, open its next frame.
+///
+/// Consoles are dealt out evenly to workers at the start of a step; a worker, which runs out of its
+/// own consoles, steals half of the remaining ones of another worker, so that uneven frame costs
+/// do not leave any of them idle.
+void racer_batch_step(racer_batch *batch, const uint8_t *inputs, uint8_t *frames, size_t frame_size);
+
+#endif /* batch_h */
@@ -10,6 +10,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <pthread.h>
 
 void racer_cartridge_reset(racer_cartridge_type type, void *cartridge_ptr) {
 	switch (type) {
@@ -26,6 +28,140 @@ void racer_cartridge_reset(racer_cartridge_type type, void *cartridge_ptr) {
 	}
 }
 
+int racer_cartridge_get_size(racer_cartridge_type type) {
+	switch (type) {
+		case CARTRIDGE_ATARI_2KB:
+			return 0x800;
+		case CARTRIDGE_ATARI_4KB:
+			return 0x1000;
+		case CARTRIDGE_ATARI_8KB:
+			return 0x2000;
+		case CARTRIDGE_ATARI_12KB:
+			return 0x3000;
+		case CARTRIDGE_ATARI_16KB:
+			return 0x4000;
+		case CARTRIDGE_ATARI_32KB:
+			return 0x8000;
+	}
+	
+	return 0;
+}
+
+int racer_cartridge_get_bank_switch_address(racer_cartridge_type type) {
+	switch (type) {
+		case CARTRIDGE_ATARI_2KB:
+			return 0x800;
+		case CARTRIDGE_ATARI_8KB:
+		case CARTRIDGE_ATARI_12KB:
+			return 0xff8;
+		case CARTRIDGE_ATARI_16KB:
+			return 0xff6;
+		case CARTRIDGE_ATARI_32KB:
+			return 0xff4;
+		default:
+			return 0x1000;
+	}
+}
+
+
+// MARK: -
+// MARK: Predecoded program
+
+/// Predecoded programs of all inserted cartridges.
+static racer_cartridge_program *programs = NULL;
+static pthread_mutex_t programs_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Predecodes operations at every offset of the specified cartridge program.
+///
+/// Operations, which cross bank boundary or overlap bank switching address range, are not
+/// predecoded, since reading them has side effects or depends on the bus.
+///
+/// Basic blocks are recorded going backwards through each bank, so that block length of an operation
+/// extends that of the operation following it.
+static void predecode_program(racer_cartridge_program *program) {
+	const int bank_size = (program->type == CARTRIDGE_ATARI_2KB) ? 0x800 : 0x1000;
+	const int bank_switch_address = racer_cartridge_get_bank_switch_address(program->type);
+	
+	for (int bank = program->size - bank_size; bank >= 0; bank -= bank_size) {
+		for (int offset = bank_size - 1; offset >= 0; --offset) {
+			const int size = bank_switch_address - offset;
+			
+			predecoded *operation = &program->operations[bank + offset];
+			if (size <= 0 || !racer_mcs6507_predecode(program->data + bank + offset, size, operation)) {
+				*operation = (predecoded){0};
+				continue;
+			}
+			
+			// extend block of the next operation, unless this operation ends
+			// its own block
+			const int next_offset = offset + operation->length;
+			if (!racer_mcs6507_is_control_flow(operation) && next_offset < bank_size) {
+				const int block_length = program->operations[bank + next_offset].block_length;
+				if (block_length > 0) {
+					operation->block_length = (block_length < UINT8_MAX) ? block_length + 1 : UINT8_MAX;
+				}
+			}
+		}
+	}
+}
+
+const racer_cartridge_program *racer_cartridge_retain_program(racer_cartridge_type type, const uint8_t *data) {
+	const int size = racer_cartridge_get_size(type);
+	pthread_mutex_lock(&programs_mutex);
+	
+	// look up program of a cartridge with the same type and content
+	racer_cartridge_program *program = programs;
+	while (program != NULL) {
+		if (program->type == type && memcmp(program->data, data, size) == 0) {
+			break;
+		}
+		program = program->next;
+	}
+	
+	if (program == NULL) {
+		program = (racer_cartridge_program *)malloc(sizeof(racer_cartridge_program) + size * sizeof(predecoded));
+		program->type = type;
+		program->size = size;
+		program->reference_count = 0;
+		
+		// copy cartridge data, since the program can outlive the cartridge
+		// it was created for
+		program->data = (uint8_t *)malloc(size);
+		memcpy(program->data, data, size);
+		predecode_program(program);
+		
+		program->next = programs;
+		programs = program;
+	}
+	
+	program->reference_count += 1;
+	pthread_mutex_unlock(&programs_mutex);
+	
+	return program;
+}
+
+void racer_cartridge_release_program(const racer_cartridge_program *program) {
+	pthread_mutex_lock(&programs_mutex);
+	
+	racer_cartridge_program **link = &programs;
+	while (*link != NULL) {
+		if (*link == program) {
+			racer_cartridge_program *released = *link;
+			released->reference_count -= 1;
+			
+			if (released->reference_count == 0) {
+				*link = released->next;
+				free(released->data);
+				free(released);
+			}
+			break;
+		}
+		link = &(*link)->next;
+	}
+	
+	pthread_mutex_unlock(&programs_mutex);
+}
+
 
 // MARK: -
 // MARK: Atari single-bank cartridge
@@ -43,9 +179,29 @@ void write_atari_cartridge(void *cartridge, int address, uint8_t data) {
 	printf("%s: ignoring write at address $%03x.\n", __func__, address);
 }
 
+int map_atari_2kb_cartridge(const void *cartridge, int address) {
+	return address & 0x7ff;
+}
+
+int map_atari_4kb_cartridge(const void *cartridge, int address) {
+	return address;
+}
+
 
 // MARK: -
 // MARK: Atari mutli-bank cartridge
+atari_multi_bank_cartridge *create_atari_multi_bank_cartridge(racer_cartridge_type type, const uint8_t *data) {
+	atari_multi_bank_cartridge *cartridge = (atari_multi_bank_cartridge *)malloc(sizeof(atari_multi_bank_cartridge));
+	*cartridge = (atari_multi_bank_cartridge){
+		.bank_count = racer_cartridge_get_size(type) / 0x1000,
+		.bank_index = 0,
+		.bank_switch_address = racer_cartridge_get_bank_switch_address(type),
+		.data = data
+	};
+	
+	return cartridge;
+}
+
 uint8_t read_atari_multi_bank_cartridge(void *cartridge_ptr, int address) {
 	atari_multi_bank_cartridge *cartridge = (atari_multi_bank_cartridge *)cartridge_ptr;
 	uint8_t *data = ((uint8_t (*)[0x1000])cartridge->data)[cartridge->bank_index];
@@ -72,3 +228,8 @@ void write_atari_multi_bank_cartridge(void *cartridge_ptr, int address, uint8_t
 		}
 	}
 }
+
+int map_atari_multi_bank_cartridge(const void *cartridge_ptr, int address) {
+	const atari_multi_bank_cartridge *cartridge = (atari_multi_bank_cartridge *)cartridge_ptr;
+	return cartridge->bank_index * 0x1000 + address;
+}
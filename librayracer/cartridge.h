@@ -10,6 +10,8 @@
 
 #include <stdint.h>
 
+#include "mcs6507.h"
+
 typedef enum {
 	CARTRIDGE_ATARI_2KB,
 	CARTRIDGE_ATARI_4KB,
@@ -21,12 +23,52 @@ typedef enum {
 
 void racer_cartridge_reset(racer_cartridge_type type, void *cartridge);
 
+/// Returns the size of ROM data of a cartridge with the specified type.
+int racer_cartridge_get_size(racer_cartridge_type type);
+
+/// Returns the address in a bank of a cartridge with the specified type, at which bank switching
+/// address range starts; returns bank size for single-bank cartridges.
+int racer_cartridge_get_bank_switch_address(racer_cartridge_type type);
+
+
+// MARK: -
+// MARK: Predecoded program
+
+/// Operations predecoded at every offset of cartridge ROM.
+///
+/// Programs are keyed by cartridge type and ROM content, and are shared by all consoles running the
+/// same cartridge. Offsets are those returned by cartridge map functions, so operations of every
+/// bank are predecoded at once and remain valid across bank switches.
+typedef struct racer_cartridge_program {
+	racer_cartridge_type type;
+	int size;
+	uint8_t *data;
+	
+	int reference_count;
+	struct racer_cartridge_program *next;
+	
+	predecoded operations[];
+} racer_cartridge_program;
+
+/// Returns predecoded program of a cartridge with the specified type and ROM data, predecoding it
+/// when no console is running the same cartridge yet.
+///
+/// Each retained program must be released with `racer_cartridge_release_program`.
+const racer_cartridge_program *racer_cartridge_retain_program(racer_cartridge_type type, const uint8_t *data);
+
+/// Releases the specified predecoded program, freeing it when no longer used by any console.
+void racer_cartridge_release_program(const racer_cartridge_program *program);
+
+
 // MARK: -
 // MARK: Atari single-bank cartridge
 uint8_t read_atari_2kb_cartridge(void *cartridge, int address);
 uint8_t read_atari_4kb_cartridge(void *cartridge, int address);
 void write_atari_cartridge(void *cartridge, int address, uint8_t data);
 
+int map_atari_2kb_cartridge(const void *cartridge, int address);
+int map_atari_4kb_cartridge(const void *cartridge, int address);
+
 
 // MARK: -
 // MARK: Atari multi-bank cartridge
@@ -38,7 +80,11 @@ typedef struct {
 	const uint8_t *data;
 } atari_multi_bank_cartridge;
 
+/// Creates Atari multi-bank cartridge with the specified type and ROM data.
+atari_multi_bank_cartridge *create_atari_multi_bank_cartridge(racer_cartridge_type type, const uint8_t *data);
+
 uint8_t read_atari_multi_bank_cartridge(void *cartridge, int address);
 void write_atari_multi_bank_cartridge(void *cartridge, int address, uint8_t data);
+int map_atari_multi_bank_cartridge(const void *cartridge, int address);
 
 #endif /* cartridge_h */
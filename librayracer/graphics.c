@@ -8,61 +8,9 @@
 #include "graphics.h"
 #include "tia.h"
 
-// MARK: Drawing
-static bool is_player_visible(const racer_player *player) {
-	int section = player->position >> 3;		// position / 8
-	section >>= player->scale;					// position / size
-	
-	// ensure position counter is within any of the 8-color clock wide
-	// sections of a scan line where a player copy can be drawn
-	if ((player->copy_mask & (1 << section)) == 0) {
-		return false;
-	}
-	
-	const int size = 8 << player->scale;
-	int bit = player->position & (size - 1);	// position % size
-	bit >>= player->scale;
-	
-	const int graphics = player->graphics[player->control & 0x3];
-	return graphics & (1 << bit);
-}
-
-static bool is_missile_visible(const racer_missile *missile) {
-	// ensure missile is enabled and not reset to player
-	if (missile->control != MISSILE_ENABLED) {
-		return false;
-	}
-	
-	// ensure position counter is within one of the 8-color clock wide
-	// sections of a scan line where a missile copy can be drawn
-	const int section = missile->position >> 3;	// position / 8
-	if ((missile->copy_mask & (1 << section)) == 0) {
-		return false;
-	}
-	
-	const int bit = missile->position & 0x7;	// position % 8
-	return bit < missile->size;
-}
-
-static bool is_ball_visible(const racer_ball *ball) {
-	// ensure ball is enabled
-	if ((ball->control != BALL_ENABLED_0) &&
-		(ball->control != (BALL_ENABLED_1 | BALL_DELAYED))) {
-		return false;
-	}
-	
-	return ball->position < ball->size;
-}
-
-static bool is_playfield_visible(const racer_playfield *playfield, int position) {
-	const bool is_reflected = playfield->control & PLAYFIELD_REFLECTED;
-	const uint64_t graphics = playfield->graphics[is_reflected];
-	
-	// each bit of playfield graphics draws for 4 color clocks
-	const int bit = position >> 2;		// position / 4
-	return graphics & (1L << bit);
-}
+#include <string.h>
 
+// MARK: Drawing
 uint16_t get_object_draw_state(const struct racer_tia *tia) {
 	// right screen half
 	const int position = tia->color_clock - 68;
@@ -72,11 +20,11 @@ uint16_t get_object_draw_state(const struct racer_tia *tia) {
 	state |= (tia->playfield.control & 0x6);
 	
 	// graphics objects
-	state |= is_player_visible(&tia->players[0]) << 3;
-	state |= is_player_visible(&tia->players[1]) << 4;
-	state |= is_missile_visible(&tia->missiles[0]) << 5;
-	state |= is_missile_visible(&tia->missiles[1]) << 6;
-	state |= is_ball_visible(&tia->ball) << 7;
+	state |= is_player_visible(&tia->players[0], racer_tia_get_position(tia, tia->players[0].start_position)) << 3;
+	state |= is_player_visible(&tia->players[1], racer_tia_get_position(tia, tia->players[1].start_position)) << 4;
+	state |= is_missile_visible(&tia->missiles[0], racer_tia_get_position(tia, tia->missiles[0].start_position)) << 5;
+	state |= is_missile_visible(&tia->missiles[1], racer_tia_get_position(tia, tia->missiles[1].start_position)) << 6;
+	state |= is_ball_visible(&tia->ball, racer_tia_get_position(tia, tia->ball.start_position)) << 7;
 	state |= is_playfield_visible(&tia->playfield, position) << 8;
 	
 	return state;
@@ -176,6 +124,327 @@ static uint16_t get_collision_state(uint16_t draw_state) {
 }
 
 
+// MARK: -
+// MARK: Coverage masks
+
+/// Player graphics, indexed by player scale and graphics byte, with each bit repeated for as many
+/// color clocks as it draws.
+static uint32_t scaled_graphics[3][0x100];
+
+/// Adds the specified bits to a coverage mask, starting at the specified value of position counter.
+static void add_coverage(uint64_t coverage[4], int position, uint64_t bits) {
+	const int shift = position & 0x3f;
+	coverage[position >> 6] |= bits << shift;
+	if (shift != 0) {
+		coverage[(position >> 6) + 1] |= bits >> (64 - shift);
+	}
+}
+
+void update_player_coverage(racer_player *player) {
+	memset(player->coverage, 0x00, sizeof(player->coverage));
+	
+	// each copy section is as wide as a player copy
+	const int size = 8 << player->scale;
+	const uint32_t graphics = scaled_graphics[player->scale][player->graphics[player->control & 0x3]];
+	for (int section = 0; section * size < 160; ++section) {
+		if (player->copy_mask & (1 << section)) {
+			add_coverage(player->coverage, section * size, graphics);
+		}
+	}
+}
+
+void update_missile_coverage(racer_missile *missile) {
+	memset(missile->coverage, 0x00, sizeof(missile->coverage));
+	
+	// missile is drawn neither when disabled, nor when reset to player
+	if (missile->control != MISSILE_ENABLED) {
+		return;
+	}
+	for (int section = 0; section < 160 / 8; ++section) {
+		if (missile->copy_mask & (1 << section)) {
+			add_coverage(missile->coverage, section * 8, (1 << missile->size) - 1);
+		}
+	}
+}
+
+void update_ball_coverage(racer_ball *ball) {
+	memset(ball->coverage, 0x00, sizeof(ball->coverage));
+	if (is_ball_enabled(ball)) {
+		ball->coverage[0] = (1 << ball->size) - 1;
+	}
+}
+
+/// Returns whether the specified coverage mask has any bit set.
+static inline bool has_coverage(const uint64_t coverage[4]) {
+	return coverage[0] | coverage[1] | coverage[2];
+}
+
+/// Returns coverage of at least 64 consecutive values of position counter, starting at the specified
+/// one, which must be visible.
+static inline uint64_t get_coverage_window(const uint64_t coverage[4], int position) {
+	const int shift = position & 0x3f;
+	const uint64_t window = coverage[position >> 6] >> shift;
+	return (shift != 0) ? window | (coverage[(position >> 6) + 1] << (64 - shift)) : window;
+}
+
+/// Playfield graphics nibbles, with each bit repeated for 4 color clocks.
+static uint16_t scaled_playfield[0x10];
+
+void update_playfield_coverage(racer_playfield *playfield) {
+	const bool is_reflected = playfield->control & PLAYFIELD_REFLECTED;
+	const uint64_t graphics = playfield->graphics[is_reflected];
+	
+	memset(playfield->coverage, 0x00, sizeof(playfield->coverage));
+	for (int nibble = 0; nibble < 10; ++nibble) {
+		add_coverage(playfield->coverage, nibble * 16, scaled_playfield[(graphics >> (nibble * 4)) & 0xf]);
+	}
+}
+
+
+// MARK: -
+// MARK: Span drawing
+
+/// Indices of objects in collision state.
+enum {
+	OBJECT_PLAYER_0,
+	OBJECT_PLAYER_1,
+	OBJECT_MISSILE_0,
+	OBJECT_MISSILE_1,
+	OBJECT_BALL,
+	OBJECT_PLAYFIELD,
+	OBJECT_COUNT
+};
+
+/**
+ * Returns coverage masks of all objects, which draw at any of the color clocks of a span, along with
+ * values of their position counters at the first one, and `NULL` for objects which do not.
+ *
+ * Returns a set of drawn objects, with a bit set at index of every one.
+ */
+static int get_object_coverages(const racer_tia *tia, const uint64_t *coverages[OBJECT_COUNT], int positions[OBJECT_COUNT]) {
+	const struct {
+		const uint64_t *coverage;
+		int position;
+	} objects[OBJECT_COUNT - 1] = {
+		{tia->players[0].coverage, racer_tia_get_position(tia, tia->players[0].start_position)},
+		{tia->players[1].coverage, racer_tia_get_position(tia, tia->players[1].start_position)},
+		{tia->missiles[0].coverage, racer_tia_get_position(tia, tia->missiles[0].start_position)},
+		{tia->missiles[1].coverage, racer_tia_get_position(tia, tia->missiles[1].start_position)},
+		{tia->ball.coverage, racer_tia_get_position(tia, tia->ball.start_position)}
+	};
+	int drawn_objects = 0;
+	for (int object = 0; object < OBJECT_COUNT - 1; ++object) {
+		const uint64_t *coverage = objects[object].coverage;
+		const bool is_drawn = objects[object].position < 160 && has_coverage(coverage);
+		coverages[object] = is_drawn ? coverage : NULL;
+		positions[object] = objects[object].position;
+		drawn_objects |= is_drawn << object;
+	}
+	
+	const bool is_reflected = tia->playfield.control & PLAYFIELD_REFLECTED;
+	const bool is_drawn = tia->playfield.graphics[is_reflected] != 0;
+	coverages[OBJECT_PLAYFIELD] = is_drawn ? tia->playfield.coverage : NULL;
+	positions[OBJECT_PLAYFIELD] = tia->color_clock - 68;
+	return drawn_objects | (is_drawn << OBJECT_PLAYFIELD);
+}
+
+/**
+ * Adds collisions a 64 color clock window at a time, by intersecting coverage of every pair of drawn
+ * objects, which have not collided yet.
+ */
+void add_collisions(racer_tia *tia, int clocks) {
+	const uint64_t *coverages[OBJECT_COUNT];
+	int positions[OBJECT_COUNT];
+	const int drawn_objects = get_object_coverages(tia, coverages, positions);
+	
+	// collisions between pairs of drawn objects, which are not latched yet
+	uint16_t pending_collisions = collisions[drawn_objects] & ~tia->collisions;
+	
+	for (int clock = 0; clock < clocks && pending_collisions != 0; clock += 64) {
+		const int remaining_clocks = clocks - clock;
+		const uint64_t drawn = (remaining_clocks < 64) ? (1ull << remaining_clocks) - 1 : UINT64_MAX;
+		
+		uint64_t windows[OBJECT_COUNT];
+		for (int object = 0; object < OBJECT_COUNT; ++object) {
+			windows[object] = (coverages[object] != NULL)
+			? get_coverage_window(coverages[object], positions[object] + clock) & drawn
+			: 0;
+		}
+		
+		for (int object = 0; object < OBJECT_COUNT; ++object) {
+			for (int other = object + 1; other < OBJECT_COUNT && windows[object] != 0; ++other) {
+				const uint16_t collision = collisions[(1 << object) | (1 << other)];
+				if ((pending_collisions & collision) && (windows[object] & windows[other])) {
+					tia->collisions |= collision;
+					pending_collisions &= ~collision;
+				}
+			}
+		}
+	}
+}
+
+bool can_add_collisions(const racer_tia *tia) {
+	int objects = 0;
+	for (int index = 0; index < 2; ++index) {
+		// players draw their main copy once their position counters wrap
+		// around, if they do
+		const racer_player *player = &tia->players[index];
+		const bool is_copied = (player->copy_mask & 0x1) == 0 && racer_tia_get_position(tia, player->start_position) < 160;
+		const bool is_drawn = has_coverage(player->coverage) || (is_copied && player->graphics[player->control & 0x3] != 0);
+		objects |= is_drawn << (OBJECT_PLAYER_0 + index);
+	}
+	
+	// missiles can be reset to players, and be drawn past their current
+	// position counters
+	objects |= has_coverage(tia->missiles[0].coverage) << OBJECT_MISSILE_0;
+	objects |= has_coverage(tia->missiles[1].coverage) << OBJECT_MISSILE_1;
+	objects |= has_coverage(tia->ball.coverage) << OBJECT_BALL;
+	objects |= has_coverage(tia->playfield.coverage) << OBJECT_PLAYFIELD;
+	
+	return (collisions[objects] & ~tia->collisions) != 0;
+}
+
+#if defined(__GNUC__)
+#if defined(__AVX2__)
+#define GRAPHICS_VECTOR_SIZE 32
+#else
+#define GRAPHICS_VECTOR_SIZE 16
+#endif
+
+/// A vector of consecutive color clocks, which compiles to SSE2 or AVX2 on x86-64 and to NEON on ARM.
+typedef uint8_t graphics_vector __attribute__((vector_size(GRAPHICS_VECTOR_SIZE)));
+
+/// Masks of 8 consecutive color clocks, indexed by their coverage bits, which are 0xff at covered
+/// color clocks and 0x00 elsewhere.
+static uint8_t coverage_masks[0x100][8];
+
+/// Indices of vector lanes.
+static const uint8_t lane_indices[32] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+};
+
+static inline graphics_vector load_vector(const uint8_t *data) {
+	graphics_vector vector;
+	memcpy(&vector, data, sizeof(vector));
+	return vector;
+}
+
+/// Expands the specified coverage bits into a vector mask of color clocks.
+static inline graphics_vector expand_coverage(uint64_t coverage) {
+	uint8_t mask[GRAPHICS_VECTOR_SIZE];
+	for (int byte = 0; byte < GRAPHICS_VECTOR_SIZE / 8; ++byte) {
+		memcpy(mask + byte * 8, coverage_masks[(coverage >> (byte * 8)) & 0xff], 8);
+	}
+	return load_vector(mask);
+}
+
+static inline graphics_vector blend_vectors(graphics_vector mask, graphics_vector vector, graphics_vector other) {
+	return (mask & vector) | (~mask & other);
+}
+
+/**
+ * Draws colors of the specified coverage masks of objects, a vector of color clocks at a time.
+ *
+ * Colors are resolved by blending object colors in reverse order of their priority.
+ */
+static void draw_colors(racer_tia *tia, int clocks, const uint64_t *coverages[OBJECT_COUNT], const int positions[OBJECT_COUNT]) {
+	const graphics_vector lanes = load_vector(lane_indices);
+	const bool has_priority = tia->playfield.control & PLAYFIELD_PRIORITY;
+	const graphics_vector score_mode = (graphics_vector){} + (uint8_t)((tia->playfield.control & PLAYFIELD_SCORE_MODE) ? 0xff : 0x00);
+	const graphics_vector colors[4] = {
+		(graphics_vector){} + tia->colors[0],
+		(graphics_vector){} + tia->colors[1],
+		(graphics_vector){} + tia->colors[2],
+		(graphics_vector){} + tia->colors[3]
+	};
+	
+	const int start_position = tia->color_clock - 68;
+	for (int clock = 0; clock < clocks; clock += GRAPHICS_VECTOR_SIZE) {
+		// mask off color clocks past the drawn ones
+		const int remaining_clocks = clocks - clock;
+		const graphics_vector drawn = (graphics_vector)(lanes < (uint8_t)((remaining_clocks < GRAPHICS_VECTOR_SIZE) ? remaining_clocks : GRAPHICS_VECTOR_SIZE));
+		
+		graphics_vector objects[OBJECT_COUNT];
+		for (int object = 0; object < OBJECT_COUNT; ++object) {
+			if (coverages[object] != NULL) {
+				const uint64_t coverage = get_coverage_window(coverages[object], positions[object] + clock);
+				objects[object] = expand_coverage(coverage) & drawn;
+			} else {
+				objects[object] = (graphics_vector){};
+			}
+		}
+		
+		const graphics_vector right_half = (graphics_vector)((lanes + (uint8_t)(start_position + clock)) >= 80);
+		const graphics_vector player_0 = objects[OBJECT_PLAYER_0] | objects[OBJECT_MISSILE_0];
+		const graphics_vector player_1 = objects[OBJECT_PLAYER_1] | objects[OBJECT_MISSILE_1];
+		
+		// playfield draws over everything once it has priority, and also
+		// when it is drawn without (see `get_draw_index`)
+		graphics_vector playfield = objects[OBJECT_PLAYFIELD];
+		if (has_priority) {
+			playfield |= right_half | score_mode | player_0 | player_1 | objects[OBJECT_BALL];
+		}
+		
+		graphics_vector color = colors[3];
+		color = blend_vectors(objects[OBJECT_BALL], colors[2], color);
+		color = blend_vectors(player_1, colors[1], color);
+		color = blend_vectors(player_0, colors[0], color);
+		color = blend_vectors(playfield, colors[2], color);
+		memcpy(tia->video_buffer + clock, &color, (remaining_clocks < GRAPHICS_VECTOR_SIZE) ? remaining_clocks : GRAPHICS_VECTOR_SIZE);
+	}
+}
+
+#else
+
+/**
+ * Draws colors of the specified coverage masks of objects, a color clock at a time.
+ */
+static void draw_colors(racer_tia *tia, int clocks, const uint64_t *coverages[OBJECT_COUNT], const int positions[OBJECT_COUNT]) {
+	const int start_position = tia->color_clock - 68;
+	
+	// draw states of all color clocks, built an object at a time
+	uint16_t states[160];
+	for (int clock = 0; clock < clocks; ++clock) {
+		states[clock] = ((start_position + clock) >= 80) | (tia->playfield.control & 0x6);
+	}
+	for (int object = 0; object < OBJECT_COUNT; ++object) {
+		if (coverages[object] == NULL) {
+			continue;
+		}
+		for (int clock = 0; clock < clocks; ++clock) {
+			states[clock] |= is_covered(coverages[object], positions[object] + clock) << (object + 3);
+		}
+	}
+	
+	for (int clock = 0; clock < clocks; ++clock) {
+		tia->video_buffer[clock] = tia->colors[draw_indices[states[clock]]];
+	}
+}
+
+#endif
+
+void draw_graphics(racer_tia *tia, int clocks) {
+	// color clocks are all blank during vertical blanking
+	if (tia->output_control & TIA_OUTPUT_VERTICAL_BLANK) {
+		memset(tia->video_buffer, 1, clocks);
+		return;
+	}
+	
+	const uint64_t *coverages[OBJECT_COUNT];
+	int positions[OBJECT_COUNT];
+	const int drawn_objects = get_object_coverages(tia, coverages, positions);
+	
+	// color clocks are all background when none of objects are drawn,
+	// unless playfield has priority (see `get_draw_index`)
+	if (drawn_objects == 0 && (tia->playfield.control & PLAYFIELD_PRIORITY) == 0) {
+		memset(tia->video_buffer, tia->colors[3], clocks);
+		return;
+	}
+	draw_colors(tia, clocks, coverages, positions);
+}
+
+
 // MARK: -
 // MARK: Graphics
 #define flip(value, bit) \
@@ -197,8 +466,6 @@ uint8_t draw_indices[0x200];
 uint16_t collisions[0x40];
 uint8_t reflections[0x100];
 
-int null_missile_position = 0;
-
 void init_graphics(void) {
 	for (int graphics = 0x00; graphics < 0x100; ++graphics) {
 		reflections[graphics] = reflect_graphics(graphics);
@@ -209,4 +476,25 @@ void init_graphics(void) {
 	for (int state = 0x00; state < 0x40; ++state) {
 		collisions[state] = get_collision_state(state << 3);
 	}
+	
+	// repeat each bit of graphics for as many color clocks as it draws
+	for (int graphics = 0x00; graphics < 0x100; ++graphics) {
+		for (int scale = 0; scale < 3; ++scale) {
+			uint32_t bits = 0;
+			for (int bit = 0; bit < 8; ++bit) {
+				if (graphics & (1 << bit)) {
+					bits |= ((1u << (1 << scale)) - 1) << (bit << scale);
+				}
+			}
+			scaled_graphics[scale][graphics] = bits;
+		}
+#if defined(__GNUC__)
+		for (int bit = 0; bit < 8; ++bit) {
+			coverage_masks[graphics][bit] = (graphics & (1 << bit)) ? 0xff : 0x00;
+		}
+#endif
+	}
+	for (int graphics = 0x0; graphics < 0x10; ++graphics) {
+		scaled_playfield[graphics] = scaled_graphics[2][graphics] & 0xffff;
+	}
 }
@@ -9,6 +9,7 @@
 #define graphics_h
 
 #include <stdint.h>
+#include <stdbool.h>
 
 // MARK: -
 typedef struct {
@@ -18,9 +19,19 @@ typedef struct {
 	int scale;
 	uint8_t control;
 	
-	int position;
+	/**
+	 * Value of position counter at position clock 0 of the TIA; position counter itself is derived from
+	 * it, rather than advanced every color clock.
+	 */
+	int start_position;
 	int motion;
 	int *missile_position;
+	
+	/**
+	 * Coverage mask, which has a bit set at every value of position counter, at which the object
+	 * draws; rebuilt whenever any of the state it depends on changes.
+	 */
+	uint64_t coverage[4];
 } racer_player;
 
 #define PLAYER_REFLECTED (1<<0)
@@ -35,8 +46,13 @@ typedef struct {
 	int size;
 	uint8_t control;
 	
-	int position;
+	int start_position;
 	int motion;
+	
+	/**
+	 * Coverage mask, same as of a player, which is empty while the missile is disabled.
+	 */
+	uint64_t coverage[4];
 } racer_missile;
 
 #define MISSILE_ENABLED (1<<0)
@@ -48,8 +64,13 @@ typedef struct {
 	int size;
 	uint8_t control;
 	
-	int position;
+	int start_position;
 	int motion;
+	
+	/**
+	 * Coverage mask, same as of a player, which is empty while the ball is disabled.
+	 */
+	uint64_t coverage[4];
 } racer_ball;
 
 #define BALL_ENABLED_0 (1<<0)
@@ -61,6 +82,12 @@ typedef struct {
 typedef struct {
 	uint64_t graphics[2];
 	uint8_t control;
+	
+	/**
+	 * Coverage mask, same as of a player, but indexed by position of a scan line, past horizontal
+	 * blanking.
+	 */
+	uint64_t coverage[4];
 } racer_playfield;
 
 #define PLAYFIELD_REFLECTED (1<<0)
@@ -68,19 +95,93 @@ typedef struct {
 #define PLAYFIELD_PRIORITY (1<<2)
 
 
+// MARK: -
+// MARK: Drawing
+
+/**
+ * Returns whether the specified coverage mask has a bit set at the specified value of position counter.
+ *
+ * Position counters past the last visible color clock of a scan line never wrap around, so objects
+ * never draw at any of them.
+ */
+static inline bool is_covered(const uint64_t coverage[4], int position) {
+	return position < 160 && (coverage[position >> 6] >> (position & 0x3f)) & 0x1;
+}
+
+/**
+ * Returns whether the specified player draws at the specified value of its position counter.
+ */
+static inline bool is_player_visible(const racer_player *player, int position) {
+	return is_covered(player->coverage, position);
+}
+
+/**
+ * Returns whether the specified missile draws at the specified value of its position counter.
+ */
+static inline bool is_missile_visible(const racer_missile *missile, int position) {
+	return is_covered(missile->coverage, position);
+}
+
+/**
+ * Returns whether the specified ball is enabled, regardless of its position counter.
+ */
+static inline bool is_ball_enabled(const racer_ball *ball) {
+	return (ball->control == BALL_ENABLED_0)
+	|| (ball->control == (BALL_ENABLED_1 | BALL_DELAYED));
+}
+
+/**
+ * Returns whether the specified ball draws at the specified value of its position counter.
+ */
+static inline bool is_ball_visible(const racer_ball *ball, int position) {
+	return is_covered(ball->coverage, position);
+}
+
+/**
+ * Returns whether the specified playfield draws at the specified position of a scan line, past
+ * horizontal blanking.
+ */
+static inline bool is_playfield_visible(const racer_playfield *playfield, int position) {
+	const bool is_reflected = playfield->control & PLAYFIELD_REFLECTED;
+	const uint64_t graphics = playfield->graphics[is_reflected];
+	
+	// each bit of playfield graphics draws for 4 color clocks
+	const int bit = position >> 2;		// position / 4
+	return graphics & (1L << bit);
+}
+
+
 // MARK: -
 typedef struct racer_tia racer_tia;
 extern uint8_t reflections[];
 extern uint16_t collisions[];
 extern uint8_t draw_indices[];
 
-extern int null_missile_position;
-
 /**
  * Initializes look-up tables for drawing graphics and collision detection.
  */
 void init_graphics(void);
 
+/**
+ * Rebuilds coverage mask of the specified player from its current graphics, copies and scale.
+ */
+void update_player_coverage(racer_player *player);
+
+/**
+ * Rebuilds coverage mask of the specified missile from its current control, copies and size.
+ */
+void update_missile_coverage(racer_missile *missile);
+
+/**
+ * Rebuilds coverage mask of the specified ball from its current control and size.
+ */
+void update_ball_coverage(racer_ball *ball);
+
+/**
+ * Rebuilds coverage mask of the specified playfield from its current graphics and reflection.
+ */
+void update_playfield_coverage(racer_playfield *playfield);
+
 /**
  * Returns a bit set describing current drawing conditions of the TIA.
  *
@@ -107,4 +208,31 @@ uint16_t get_object_draw_state(const racer_tia *tia);
 #define TIA_DRAWS_BALL (1<<7)
 #define TIA_DRAWS_PLAYFIELD (1<<8)
 
+/**
+ * Adds collisions between objects drawn at any of the specified number of color clocks of the current
+ * scan line, past horizontal blanking.
+ *
+ * Collisions are the same as when evaluating `get_object_draw_state` and `collisions` at each of
+ * color clocks, as if position counters of objects advanced by 1 after each one. None of position
+ * counters must wrap around during the color clocks, and none of them are advanced.
+ */
+void add_collisions(racer_tia *tia, int clocks);
+
+/**
+ * Returns whether drawing any color clocks past horizontal blanking can latch any collisions, which
+ * are not latched yet, regardless of position counters of objects and of how many times they wrap
+ * around.
+ */
+bool can_add_collisions(const racer_tia *tia);
+
+/**
+ * Draws the specified number of color clocks of the current scan line, past horizontal blanking, into
+ * video buffer.
+ *
+ * Color clocks are drawn the same as by evaluating `get_object_draw_state` and `draw_indices` at
+ * each of them, under the same conditions as with `add_collisions`. Neither position counters, nor
+ * video buffer are advanced.
+ */
+void draw_graphics(racer_tia *tia, int clocks);
+
 #endif /* graphics_h */
@@ -6,898 +6,214 @@
 //
 
 #include "mcs6507.h"
-#include "flags.h"
+#include "mcs6507_operations.h"
 
 #include <stdio.h>
 
-// MARK: Convenience functionality
+// MARK: Operation decoding
 
-/// A memory address at the specified page and offset.
-#define address(high, low) \
-(((high) << 8) | (low))
-
-/// `true` when both of the specified memory addresses are on the same page; `false` otherwise.
-#define is_same_page(address1, address2) \
-(((address1) >> 8) == ((address2) >> 8))
-
-
-// MARK: -
-// MARK: Memory addressing
-
-/// Reads address, using relative addressing mode, from offset at the specified address, based on
-/// the specified branching condition.
-///
-/// Additionally returns the number of extra CPU cycles it takes to read and resolve the effective
-/// address.
-static int read_relative_address(racer_mcs6507 *cpu, int address, bool condition, int *cycles) {
-	// when branch is not taken, program counter increments to +1
-	// relative to offset operand address
-	int relative_address = address + 0x1;
+bool racer_mcs6507_predecode(const uint8_t *memory, int size, predecoded *operation) {
+	const int code = memory[0];
+	const operation_format format = operation_formats[code];
 	
-	if (condition) {
-		const int offset = cpu->read_bus(cpu->bus, address);
-		int offset_address = relative_address;
-		
-		// offset address using signed 8 bit offset and check if offsetting
-		// crosses page boundary
-		offset_address += (offset & 0x80) ? offset - 0x100 : offset;
-		*cycles = is_same_page(relative_address, offset_address) ? 1 : 2;
-		
-		relative_address = offset_address;
-	} else {
-		*cycles = 0;
+	// do not predecode unknown operations or operations, which extend
+	// past the end of memory
+	if (format.length == 0 || format.length > size) {
+		return false;
 	}
 	
-	return relative_address;
-}
-
-/// Reads 0-page address at the specified address in memory.
-static int read_0_page_address(racer_mcs6507 *cpu, int address) {
-	return cpu->read_bus(cpu->bus, address);
-}
-
-/// Reads address, using 0-page x-indexed addressing mode, reading from the specified address
-/// in memory.
-static int read_0_page_x_indexed_address(racer_mcs6507 *cpu, int address) {
-	address = read_0_page_address(cpu, address);
-	return (address + cpu->x) & 0xff;
-}
-
-/// Reads address, using 0-page y-indexed addressing mode, reading from the specified address
-/// in memory.
-static int read_0_page_y_indexed_address(racer_mcs6507 *cpu, int address) {
-	address = read_0_page_address(cpu, address);
-	return (address + cpu->y) & 0xff;
-}
-
-/// Reads address at the specified address in memory.
-static int read_address(racer_mcs6507 *cpu, int address) {
-	const int low = cpu->read_bus(cpu->bus, address);
-	const int high = cpu->read_bus(cpu->bus, address + 0x1);
+	*operation = (predecoded){
+		.code = code,
+		.addressing = format.addressing,
+		.length = format.length,
+		.duration = format.duration,
+		.page_cycles = format.page_cycles,
+		.block_length = 1
+	};
+	if (format.addressing != ADDRESSING_IMPLIED) {
+		operation->operand = memory[1];
+		if (format.length == 3) {
+			operation->operand |= memory[2] << 8;
+		}
+	}
 	
-	return address(high, low);
+	return true;
 }
 
-/// Reads address, using absolute, x-indexed addressing mode, at the specified address in memory.
-///
-/// Additionally returns the number of extra CPU cycles it takes to read and resolve the effective
-/// address.
-static int read_x_indexed_address(racer_mcs6507 *cpu, int address, int *cycles) {
-	address = read_address(cpu, address);
-	int indexed_address = address + cpu->x;
-	
-	*cycles = is_same_page(address, indexed_address) ? 0 : 1;
-	return indexed_address;
+bool racer_mcs6507_is_control_flow(const predecoded *operation) {
+	switch (operation_formats[operation->code].operation) {
+		case OPERATION_BRANCH:
+		case OPERATION_BRK:
+		case OPERATION_JMP:
+		case OPERATION_JSR:
+		case OPERATION_RTI:
+		case OPERATION_RTS:
+			return true;
+		default:
+			return false;
+	}
 }
 
-/// Reads address, using absolute, y-indexed addressing mode, at the specified address in memory.
-///
-/// Additionally returns the number of extra CPU cycles it takes to read and resolve the effective
-/// address.
-static int read_y_indexed_address(racer_mcs6507 *cpu, int address, int *cycles) {
-	address = read_address(cpu, address);
-	int indexed_address = address + cpu->y;
+void racer_mcs6507_decode_operation(racer_mcs6507 *cpu) {
+	const predecoded *cached = cpu->read_predecoded(cpu->bus, cpu->program_counter);
+	if (cached != NULL) {
+		resolve_operation(cpu, cached, cached->addressing, true);
+		return;
+	}
 	
-	*cycles = is_same_page(address, indexed_address) ? 0 : 1;
-	return indexed_address;
-}
-
-/// Reads address, using indirect addressing mode, at the specified address in memory.
-static int read_indirect_address(racer_mcs6507 *cpu, int address) {
-	address = read_address(cpu, address);
-	const int low = cpu->read_bus(cpu->bus, address);
+	const int code = cpu->read_bus(cpu->bus, cpu->program_counter);
+	const operation_format format = operation_formats[code];
+	if (format.length == 0) {
+		printf("Unknown operation code: %02x at %04x.\n", code, cpu->program_counter);
+		cpu->operation = (decoded){code, 0x0000, 1, 1};
+		return;
+	}
 	
-	// NOTE: MCS6507 has a bug in indirect addressing mode; this mode is used
-	// only in JMP instruction;
-	// when resolved jump address is at the end of a memory page, high byte of
-	// the effective jump address will not be read from (low byte address + 1),
-	// but from the beginning of that memory page instead;
-	// for instance, when jump address is at address $4aff, MCS6507 will read
-	// effective jump address:
-	//	- low byte from $4aff
-	//	- high byte from $4a00 instead of ($4aff + 1) = $4b00
-	address = (address & 0xff00) | ((address + 0x1) & 0xff);
-	const int high = cpu->read_bus(cpu->bus, address);
+	predecoded operation = {
+		.code = code,
+		.addressing = format.addressing,
+		.length = format.length,
+		.duration = format.duration,
+		.page_cycles = format.page_cycles
+	};
+	
+	// read operands, except for relative addressing, which only reads its
+	// operand when branch is taken
+	const int operand_address = cpu->program_counter + 0x1;
+	if (format.addressing == ADDRESSING_IMPLIED
+		|| format.addressing == ADDRESSING_IMMEDIATE
+		|| format.addressing == ADDRESSING_RELATIVE) {
+		// operand is not read
+	} else if (format.length == 2) {
+		operation.operand = cpu->read_bus(cpu->bus, operand_address);
+	} else {
+		operation.operand = read_address(cpu, operand_address);
+	}
 	
-	return address(high, low);
+	resolve_operation(cpu, &operation, operation.addressing, false);
 }
 
-/// Reads address, using x-indexed indirect addressing mode, at the specified address in memory.
-static int read_indirect_x_indexed_address(racer_mcs6507 *cpu, int address) {
-	// read base address and apply indexing
-	address = cpu->read_bus(cpu->bus, address);
-	address = address + cpu->x;
-	
-	const int low = cpu->read_bus(cpu->bus, address & 0xff);
-	const int high = cpu->read_bus(cpu->bus, (address + 0x1) & 0xff);
-	return address(high, low);
+
+// MARK: -
+// MARK: Operation dispatch
+
+/// Executes currently decoded operation, dispatching it through a switch over operation type.
+static void execute_switched_operation(racer_mcs6507 *cpu) {
+	const int operand_address = cpu->operation.address;
+	switch (operation_formats[cpu->operation.code].operation) {
+#define DISPATCH_HANDLER(name, NAME) \
+		case OPERATION_##NAME: \
+			execute_##name(cpu, operand_address); \
+			return;
+		OPERATIONS(DISPATCH_HANDLER)
+#undef DISPATCH_HANDLER
+			
+		default:
+			printf("Unknown operation code: %02x.\n", cpu->operation.code);
+			return;
+	}
 }
 
-/// Reads address, using indirect y-indexed addressing mode, at the specified address in memory.
+/// Executes currently decoded operation.
 ///
-/// Additionally returns the number of extra CPU cycles it takes to read and resolve the effective
-/// address.
-static int read_indirect_y_indexed_address(racer_mcs6507 *cpu, int address, int *cycles) {
-	// read indirect address
-	address = cpu->read_bus(cpu->bus, address);
+/// Operation handlers are dispatched through a table of label addresses when the compiler supports
+/// computed goto, so that each operation takes a single indirect jump; otherwise, through a switch
+/// over operation type.
+static void execute_decoded_operation(racer_mcs6507 *cpu) {
+#if defined(__GNUC__)
+	const int operand_address = cpu->operation.address;
 	
-	// read base address
-	const int low = cpu->read_bus(cpu->bus, address);
-	const int high = cpu->read_bus(cpu->bus, (address + 0x1) & 0xff);
-	address = address(high, low);
+#define DISPATCH_LABEL(name, NAME) [OPERATION_##NAME] = &&name,
+	static const void *const handlers[OPERATION_COUNT] = {
+		[OPERATION_UNKNOWN] = &&unknown,
+		OPERATIONS(DISPATCH_LABEL)
+	};
+#undef DISPATCH_LABEL
+	goto *handlers[operation_formats[cpu->operation.code].operation];
+	
+#define DISPATCH_HANDLER(name, NAME) \
+	name: \
+		execute_##name(cpu, operand_address); \
+		return;
+	OPERATIONS(DISPATCH_HANDLER)
+#undef DISPATCH_HANDLER
 	
-	// apply indexing
-	int indexed_address = address + cpu->y;
-	*cycles = is_same_page(address, indexed_address) ? 0 : 1;
-	return indexed_address;
+unknown:
+	printf("Unknown operation code: %02x.\n", cpu->operation.code);
+#else
+	execute_switched_operation(cpu);
+#endif
 }
 
 
 // MARK: -
-// MARK: Stack management
+// MARK: Compiled operations
 
-/// Pushes the specified value onto stack and updates the stack pointer.
-static void push_stack(racer_mcs6507 *cpu, int data) {
-	const int address = cpu->stack_pointer + 0x0100;
-	cpu->write_bus(cpu->bus, address, data);
-	cpu->stack_pointer = (cpu->stack_pointer - 0x1) & 0xff;
-}
+/// Execution handlers of all operations, indexed by operation type.
+static void (* const execute_handlers[OPERATION_COUNT])(racer_mcs6507 *, int) = {
+#define EXECUTE_HANDLER(name, NAME) [OPERATION_##NAME] = execute_##name,
+	OPERATIONS(EXECUTE_HANDLER)
+#undef EXECUTE_HANDLER
+};
 
-/// Pulls the last pushed value from the stack and updates the stack pointer.
-static int pull_stack(racer_mcs6507 *cpu) {
-	cpu->stack_pointer = (cpu->stack_pointer + 0x1) & 0xff;
-	
-	const int address = cpu->stack_pointer + 0x0100;
-	return cpu->read_bus(cpu->bus, address);
+/// Defines a handler, which resolves predecoded operations with the specified addressing mode.
+#define RESOLVE_HANDLER(name, MODE) \
+static void resolve_##name(racer_mcs6507 *cpu, const predecoded *operation) { \
+	resolve_operation(cpu, operation, ADDRESSING_##MODE, true); \
 }
 
+RESOLVE_HANDLER(implied, IMPLIED)
+RESOLVE_HANDLER(immediate, IMMEDIATE)
+RESOLVE_HANDLER(relative, RELATIVE)
+RESOLVE_HANDLER(0_page, 0_PAGE)
+RESOLVE_HANDLER(0_page_x_indexed, 0_PAGE_X_INDEXED)
+RESOLVE_HANDLER(0_page_y_indexed, 0_PAGE_Y_INDEXED)
+RESOLVE_HANDLER(absolute, ABSOLUTE)
+RESOLVE_HANDLER(x_indexed, X_INDEXED)
+RESOLVE_HANDLER(y_indexed, Y_INDEXED)
+RESOLVE_HANDLER(indirect, INDIRECT)
+RESOLVE_HANDLER(indirect_x_indexed, INDIRECT_X_INDEXED)
+RESOLVE_HANDLER(indirect_y_indexed, INDIRECT_Y_INDEXED)
+#undef RESOLVE_HANDLER
 
-// MARK: -
-// MARK: Operation execution
+/// Resolution handlers of all addressing modes, indexed by addressing mode.
+static void (* const resolve_handlers[])(racer_mcs6507 *, const predecoded *) = {
+	[ADDRESSING_IMPLIED] = resolve_implied,
+	[ADDRESSING_IMMEDIATE] = resolve_immediate,
+	[ADDRESSING_RELATIVE] = resolve_relative,
+	[ADDRESSING_0_PAGE] = resolve_0_page,
+	[ADDRESSING_0_PAGE_X_INDEXED] = resolve_0_page_x_indexed,
+	[ADDRESSING_0_PAGE_Y_INDEXED] = resolve_0_page_y_indexed,
+	[ADDRESSING_ABSOLUTE] = resolve_absolute,
+	[ADDRESSING_X_INDEXED] = resolve_x_indexed,
+	[ADDRESSING_Y_INDEXED] = resolve_y_indexed,
+	[ADDRESSING_INDIRECT] = resolve_indirect,
+	[ADDRESSING_INDIRECT_X_INDEXED] = resolve_indirect_x_indexed,
+	[ADDRESSING_INDIRECT_Y_INDEXED] = resolve_indirect_y_indexed
+};
 
-/// Decodes operation at the specified address.
-static void decode_operation(racer_mcs6507 *cpu) {
-	const int opcode = cpu->read_bus(cpu->bus, cpu->program_counter);
-	int address = cpu->program_counter + 0x1;
-	int cycles = 0;
-	
-	switch (opcode) {
-			// MARK: implied addressing
-		case 0x18: case 0x38: case 0x58: case 0xb8: case 0xd8: case 0x78: case 0x88: case 0xa8: case 0x98: case 0xc8: case 0xe8: case 0xf8:
-		case 0x0a: case 0x2a: case 0x4a: case 0x6a: case 0x8a: case 0x9a: case 0xaa: case 0xba: case 0xca: case 0xea:
-			cpu->operation = (decoded){opcode, -1, 2, 1};
-			break;
-		case 0x08: case 0x48:
-			cpu->operation = (decoded){opcode, -1, 3, 1};
-			break;
-		case 0x28: case 0x68:
-			cpu->operation = (decoded){opcode, -1, 4, 1};
-			break;
-		case 0x40: case 0x60:
-			cpu->operation = (decoded){opcode, -1, 6, 1};
-			break;
-		case 0x00:
-			// NOTE: even though BRK instruction length is 1 byte, return
-			// address on the stack is program counter + 2
-			cpu->operation = (decoded){opcode, -1, 7, 2};
-			break;
-			
-			// MARK: immediate addressing
-		case 0xa2:
-		case 0x09: case 0x29: case 0x49: case 0x69: case 0xa9: case 0xc9: case 0xe9:
-		case 0xa0: case 0xe0: case 0xc0:
-			cpu->operation = (decoded){opcode, address, 2, 2};
-			break;
-			
-			// MARK: relative addressing
-		case 0x10: {
-			const bool condition = !is_flag_set(cpu->status, MCS6507_STATUS_NEGATIVE);
-			address = read_relative_address(cpu, address, condition, &cycles);
-			cpu->operation = (decoded){opcode, address, 2 + cycles, 2};
-			break;
-		}
-		case 0x30: {
-			const bool condition = is_flag_set(cpu->status, MCS6507_STATUS_NEGATIVE);
-			address = read_relative_address(cpu, address, condition, &cycles);
-			cpu->operation = (decoded){opcode, address, 2 + cycles, 2};
-			break;
-		}
-		case 0x50: {
-			const bool condition = !is_flag_set(cpu->status, MCS6507_STATUS_OVERFLOW);
-			address = read_relative_address(cpu, address, condition, &cycles);
-			cpu->operation = (decoded){opcode, address, 2 + cycles, 2};
-			break;
-		}
-		case 0x70: {
-			const bool condition = is_flag_set(cpu->status, MCS6507_STATUS_OVERFLOW);
-			address = read_relative_address(cpu, address, condition, &cycles);
-			cpu->operation = (decoded){opcode, address, 2 + cycles, 2};
-			break;
-		}
-		case 0x90: {
-			const bool condition = !is_flag_set(cpu->status, MCS6507_STATUS_CARRY);
-			address = read_relative_address(cpu, address, condition, &cycles);
-			cpu->operation = (decoded){opcode, address, 2 + cycles, 2};
-			break;
-		}
-		case 0xb0: {
-			const bool condition = is_flag_set(cpu->status, MCS6507_STATUS_CARRY);
-			address = read_relative_address(cpu, address, condition, &cycles);
-			cpu->operation = (decoded){opcode, address, 2 + cycles, 2};
-			break;
-		}
-		case 0xd0: {
-			const bool condition = !is_flag_set(cpu->status, MCS6507_STATUS_ZERO);
-			address = read_relative_address(cpu, address, condition, &cycles);
-			cpu->operation = (decoded){opcode, address, 2 + cycles, 2};
-			break;
-		}
-		case 0xf0: {
-			const bool condition = is_flag_set(cpu->status, MCS6507_STATUS_ZERO);
-			address = read_relative_address(cpu, address, condition, &cycles);
-			cpu->operation = (decoded){opcode, address, 2 + cycles, 2};
-			break;
-		}
-			
-			// MARK: 0-page absolute addressing
-		case 0x24: case 0x84: case 0xa4: case 0xc4: case 0xe4:
-		case 0x05: case 0x25: case 0x45: case 0x65: case 0x85: case 0xa5: case 0xc5: case 0xe5:
-		case 0xa6: case 0x86: {
-			address = read_0_page_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 3, 2};
-			break;
-		}
-		case 0x06: case 0x26: case 0x46: case 0x66: case 0xc6: case 0xe6: {
-			address = read_0_page_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 5, 2};
-			break;
-		}
-			
-			// MARK: 0-page x-indexed addressing
-		case 0x94: case 0xb4:
-		case 0x15: case 0x35: case 0x55: case 0x75: case 0x95: case 0xb5: case 0xd5: case 0xf5: {
-			address = read_0_page_x_indexed_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 4, 2};
-			break;
-		}
-		case 0x16: case 0x36: case 0x56: case 0x76: case 0xd6: case 0xf6: {
-			address = read_0_page_x_indexed_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 6, 2};
-			break;
-		}
-			
-			// MARK: 0-page y-indexed addressing
-		case 0x96: case 0xb6: {
-			address = read_0_page_y_indexed_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 4, 2};
-			break;
-		}
-			
-			// MARK: absolute addressing
-		case 0x4c: {
-			address = read_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 3, 3};
-			break;
-		}
-		case 0x2c: case 0x8c: case 0xac: case 0xcc: case 0xec:
-		case 0x0d: case 0x2d: case 0x4d: case 0x6d: case 0x8d: case 0xad: case 0xcd: case 0xed:
-		case 0x8e: case 0xae: {
-			address = read_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 4, 3};
-			break;
-		}
-		case 0x20:
-		case 0x0e: case 0x2e: case 0x4e: case 0x6e: case 0xce: case 0xee: {
-			address = read_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 6, 3};
-			break;
-		}
-			
-			// MARK: absolute x-indexed addressing
-		case 0xbc:
-		case 0x1d: case 0x3d: case 0x5d: case 0x7d: case 0xbd: case 0xdd: case 0xfd: {
-			address = read_x_indexed_address(cpu, address, &cycles);
-			cpu->operation = (decoded){opcode, address, 4 + cycles, 3};
-			break;
-		}
-		case 0x9d: {
-			address = read_x_indexed_address(cpu, address, &cycles);
-			cpu->operation = (decoded){opcode, address, 5, 3};
-			break;
-		}
-		case 0x1e: case 0x3e: case 0x5e: case 0x7e: case 0xde: case 0xfe: {
-			address = read_x_indexed_address(cpu, address, &cycles);
-			cpu->operation = (decoded){opcode, address, 7, 3};
-			break;
-		}
-			
-			// MARK: absolute y-indexed addressing
-		case 0x19: case 0x39: case 0x59: case 0x79: case 0xb9: case 0xd9: case 0xf9:
-		case 0xbe: {
-			address = read_y_indexed_address(cpu, address, &cycles);
-			cpu->operation = (decoded){opcode, address, 4 + cycles, 3};
-			break;
-		}
-		case 0x99: {
-			address = read_y_indexed_address(cpu, address, &cycles);
-			cpu->operation = (decoded){opcode, address, 5, 3};
-			break;
-		}
-			
-			// MARK: indirect addressing
-		case 0x6c: {
-			address = read_indirect_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 5, 3};
-			break;
-		}
-			
-			// MARK: indirect x-indexed addressing
-		case 0x61: case 0x21: case 0xc1: case 0x41: case 0xa1: case 0x01: case 0xe1: case 0x81: {
-			address = read_indirect_x_indexed_address(cpu, address);
-			cpu->operation = (decoded){opcode, address, 6, 2};
-			break;
-		}
-			
-			// MARK: indirect y-indexed addressing
-		case 0x11: case 0x31: case 0x51: case 0x71: case 0xb1: case 0xd1: case 0xf1: {
-			address = read_indirect_y_indexed_address(cpu, address, &cycles);
-			cpu->operation = (decoded){opcode, address, 5 + cycles, 2};
-			break;
-		}
-			// MARK: indirect y-indexed addressing (sta-only)
-		case 0x91:
-			// NOTE: sta with indirect y-indexed addressing always takes
-			// 6 clock cycles
-			address = read_indirect_y_indexed_address(cpu, address, &cycles);
-			cpu->operation = (decoded){opcode, address, 6, 2};
-			break;
-			
-		default:
-			printf("Unknown operation code: %02x at %04x.\n", opcode, address - 0x1);
-			cpu->operation = (decoded){opcode, 0x0000, 1, 1};
-			break;
-	}
+racer_mcs6507_handlers racer_mcs6507_get_handlers(const predecoded *operation) {
+	return (racer_mcs6507_handlers){
+		.execute = execute_handlers[operation_formats[operation->code].operation],
+		.resolve = resolve_handlers[operation->addressing]
+	};
 }
 
-/// Executes currently decoded operation.
-static void execute_decoded_operation(racer_mcs6507 *cpu) {
-	const int operand_address = cpu->operation.address;
-	switch (cpu->operation.code) {
-			// MARK: adc
-		case 0x61: case 0x65: case 0x69: case 0x6d: case 0x71: case 0x75: case 0x7d: case 0x79: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const bool carry = is_flag_set(cpu->status, MCS6507_STATUS_CARRY);
-			
-			int result = cpu->accumulator + operand + carry;
-			const int overflow = (cpu->accumulator ^ result) & (operand ^ result);
-			
-			// NOTE: status flags are set from intermediary result, not
-			// decimal mode corrected one
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, result > 0xff);
-			set_flag(cpu->status, MCS6507_STATUS_OVERFLOW, overflow & 0x80);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, (result & 0xff) == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			
-			if (is_flag_set(cpu->status, MCS6507_STATUS_DECIMAL_MODE)) {
-				// (accumulator % 0x10) + (operand % 0x10)
-				int low = (cpu->accumulator & 0x0f) + (operand & 0x0f) + carry;
-				// (accumulator / 0x10) + (operand / 0x10)
-				int high = (cpu->accumulator >> 4) + (operand >> 4);
-				
-				if (low > 0x9) {
-					low -= 0xa;
-					high += 0x1;
-				}
-				if (high > 0x9) {
-					high -= 0xa;
-					add_flag(cpu->status, MCS6507_STATUS_CARRY);
-				} else {
-					clear_flag(cpu->status, MCS6507_STATUS_CARRY);
-				}
-				
-				// high * 0x10 + low
-				result = (high << 4) | (low & 0x0f);
-			}
-			
-			cpu->accumulator = result & 0xff;
-			break;
-		}
-			
-			// MARK: and
-		case 0x21: case 0x25: case 0x29: case 0x2d: case 0x31: case 0x35: case 0x39: case 0x3d: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			cpu->accumulator &= operand;
-			
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-		}
-			
-			// MARK: asl (accumulator)
-		case 0x0a: {
-			const bool carry = cpu->accumulator & 0x80;
-			const int result = (cpu->accumulator << 1) & 0xff;
-			
-			cpu->accumulator = result;
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, carry);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-		}
-			
-			// MARK: asl
-		case 0x06: case 0x0e: case 0x16: case 0x1e: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = (operand << 1) & 0xff;
-			
-			cpu->write_bus(cpu->bus, operand_address, result);
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, operand & 0x80);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: bcc, bcs, beq, bmi, bne, bpl, bvc, bvs
-		case 0x90: case 0xb0: case 0xf0: case 0x30: case 0xd0: case 0x10: case 0x50: case 0x70:
-			cpu->program_counter = operand_address;
-			break;
-			
-			// MARK: bit:
-		case 0x24: case 0x2c: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = operand & cpu->accumulator;
-			
-			set_flag(cpu->status, MCS6507_STATUS_OVERFLOW, operand & 0x40);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, operand & 0x80);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			break;
-		}
-			
-			// MARK: brk
-		case 0x00: {
-			push_stack(cpu, cpu->program_counter >> 8);
-			push_stack(cpu, cpu->program_counter & 0xff);
-			push_stack(cpu, cpu->status | MCS6507_STATUS_BREAK | MCS6507_STATUS_UNUSED);
-			
-			const int low = cpu->read_bus(cpu->bus, 0xfffe);
-			const int high = cpu->read_bus(cpu->bus, 0xffff);
-			cpu->program_counter = address(high, low);
-			
-			add_flag(cpu->status, MCS6507_STATUS_INTERRUPT_DISABLE);
-			break;
-		}
-			
-			// MARK: clc
-		case 0x18:
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, false);
-			break;
-			// MARK: cld
-		case 0xd8:
-			set_flag(cpu->status, MCS6507_STATUS_DECIMAL_MODE, false);
-			break;
-			// MARK: cli
-		case 0x58:
-			set_flag(cpu->status, MCS6507_STATUS_INTERRUPT_DISABLE, false);
-			break;
-			// MARK: clv
-		case 0xb8:
-			set_flag(cpu->status, MCS6507_STATUS_OVERFLOW, false);
-			break;
-			
-			// MARK: cmp
-		case 0xc1: case 0xc5: case 0xc9: case 0xcd: case 0xd1: case 0xd5: case 0xd9: case 0xdd: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = cpu->accumulator - operand;
-			
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, result >= 0);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: cpx
-		case 0xe0: case 0xe4: case 0xec: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = cpu->x - operand;
-			
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, result >= 0);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: cpy
-		case 0xc0: case 0xc4: case 0xcc: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = cpu->y - operand;
-			
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, result >= 0);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: dec
-		case 0xc6: case 0xce: case 0xd6: case 0xde: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = (operand - 0x1) & 0xff;
-			
-			cpu->write_bus(cpu->bus, operand_address, result);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: dex
-		case 0xca: {
-			cpu->x = (cpu->x - 0x1) & 0xff;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->x == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->x & 0x80);
-			break;
-		}
-			
-			// MARK: dey
-		case 0x88: {
-			cpu->y = (cpu->y - 0x1) & 0xff;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->y == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->y & 0x80);
-			break;
-		}
-			
-			// MARK: eor
-		case 0x41: case 0x45: case 0x49: case 0x4d: case 0x51: case 0x55: case 0x59: case 0x5d: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			
-			cpu->accumulator ^= operand;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-		}
-			
-			// MARK: inc
-		case 0xe6: case 0xee: case 0xf6: case 0xfe: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = (operand + 0x1) & 0xff;
-			
-			cpu->write_bus(cpu->bus, operand_address, result);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0x0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: inx
-		case 0xe8:
-			cpu->x = (cpu->x + 0x1) & 0xff;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->x == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->x & 0x80);
-			break;
-			
-			// MARK: iny
-		case 0xc8:
-			cpu->y = (cpu->y + 0x1) & 0xff;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->y == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->y & 0x80);
-			break;
-			
-			// MARK: jmp
-		case 0x4c: case 0x6c:
-			cpu->program_counter = operand_address;
-			break;
-			
-			// MARK: jsr
-		case 0x20: {
-			// NOTE: JSR pushes next instruction address - 1 (PC+2-1) onto
-			// stack, and there's an extra PC+1 at the end of RTS, which then
-			// correctly aligns return to the beginning of next instruction;
-			const int return_address = cpu->program_counter - 0x1;
-			push_stack(cpu, return_address >> 8);
-			push_stack(cpu, return_address & 0xff);
-			
-			cpu->program_counter = operand_address;
-			break;
-		}
-			
-			// MARK: lda
-		case 0xa1: case 0xa5: case 0xa9: case 0xad: case 0xb1: case 0xb5: case 0xb9: case 0xbd:
-			cpu->accumulator = cpu->read_bus(cpu->bus, operand_address);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-			
-			// MARK: ldx
-		case 0xa2: case 0xa6: case 0xae: case 0xb6: case 0xbe:
-			cpu->x = cpu->read_bus(cpu->bus, operand_address);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->x == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->x & 0x80);
-			break;
-			
-			// MARK: ldy
-		case 0xa0: case 0xa4: case 0xac: case 0xb4: case 0xbc:
-			cpu->y = cpu->read_bus(cpu->bus, operand_address);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->y == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->y & 0x80);
-			break;
-			
-			// MARK: lsr (accumulator)
-		case 0x4a: {
-			const bool carry = cpu->accumulator & 0x1;
-			cpu->accumulator >>= 1;
-			
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, carry);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-		}
-			
-			// MARK: lsr
-		case 0x46: case 0x4e: case 0x56: case 0x5e: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = operand >> 1;
-			
-			cpu->write_bus(cpu->bus, operand_address, result);
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, operand & 0x1);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: nop
-		case 0xea:
-			break;
-			
-			// MARK: ora
-		case 0x01: case 0x05: case 0x09: case 0x0d: case 0x11: case 0x15: case 0x19: case 0x1d: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			cpu->accumulator |= operand;
-			
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-		}
-			
-			// MARK: pha
-		case 0x48:
-			push_stack(cpu, cpu->accumulator);
-			break;
-			
-			// MARK: php
-		case 0x08: {
-			int status = cpu->status;
-			add_flag(status, MCS6507_STATUS_BREAK);
-			add_flag(status, MCS6507_STATUS_UNUSED);
-			
-			push_stack(cpu, status);
-			break;
-		}
-			
-			// MARK: pla
-		case 0x68:
-			cpu->accumulator = pull_stack(cpu);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-			
-			// MARK: plp
-		case 0x28: {
-			const int ignored_flags = (MCS6507_STATUS_BREAK | MCS6507_STATUS_UNUSED);
-			const int status = pull_stack(cpu);
-			
-			// preserve break and unused flags in status register
-			cpu->status = (status & ~ignored_flags) | (cpu->status & ignored_flags);
-			break;
-		}
-			
-			// MARK: rol (accumulator)
-		case 0x2a: {
-			const bool carry = cpu->accumulator & 0x80;
-			
-			cpu->accumulator = ((cpu->accumulator << 1) | is_flag_set(cpu->status, MCS6507_STATUS_CARRY)) & 0xff;
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, carry);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-		}
-			
-			// MARK: rol
-		case 0x26: case 0x2e: case 0x36: case 0x3e: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = ((operand << 1) | is_flag_set(cpu->status, MCS6507_STATUS_CARRY)) & 0xff;
-			
-			cpu->write_bus(cpu->bus, operand_address, result);
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, operand & 0x80);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: ror (accumulator)
-		case 0x6a: {
-			const bool carry = cpu->accumulator & 0x1;
-			cpu->accumulator = (cpu->accumulator >> 1) | (is_flag_set(cpu->status, MCS6507_STATUS_CARRY) << 7);
-			
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, carry);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-		}
-			
-			// MARK: ror
-		case 0x66: case 0x6e: case 0x76: case 0x7e: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const int result = (operand >> 1) | (is_flag_set(cpu->status, MCS6507_STATUS_CARRY) << 7);
-			
-			cpu->write_bus(cpu->bus, operand_address, result);
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, operand & 0x1);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, result == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			break;
-		}
-			
-			// MARK: rti
-		case 0x40: {
-			const int ignored_flags = (MCS6507_STATUS_BREAK | MCS6507_STATUS_UNUSED);
-			const int status = pull_stack(cpu);
-			
-			// preserve break and unused status flags
-			cpu->status = (status & ~ignored_flags) | (cpu->status & ignored_flags);
-			
-			// pull program counter from stack
-			const int low = pull_stack(cpu);
-			const int high = pull_stack(cpu);
-			cpu->program_counter = address(high, low);
-			break;
-		}
-			
-			// MARK: rts
-		case 0x60: {
-			const int low = pull_stack(cpu);
-			const int high = pull_stack(cpu);
-			cpu->program_counter = address(high, low) + 0x1;
-			break;
-		}
-			
-			// MARK: sbc
-		case 0xe1: case 0xe5: case 0xe9: case 0xed: case 0xf1: case 0xf5: case 0xf9: case 0xfd: {
-			const int operand = cpu->read_bus(cpu->bus, operand_address);
-			const bool borrow = !is_flag_set(cpu->status, MCS6507_STATUS_CARRY);
-			
-			int result = cpu->accumulator - operand - borrow;
-			const int overflow = (cpu->accumulator ^ operand) & (cpu->accumulator ^ result);
-			
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, result >= 0x0);
-			set_flag(cpu->status, MCS6507_STATUS_OVERFLOW, overflow & 0x80);
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, (result & 0xff) == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, result & 0x80);
-			
-			if (is_flag_set(cpu->status, MCS6507_STATUS_DECIMAL_MODE)) {
-				// (accumulator % 0x10) - (operand % 0x10)
-				int low = (cpu->accumulator & 0x0f) - (operand & 0x0f) - borrow;
-				// (accumulator / 0x10) - (operand / 0x10)
-				int high = (cpu->accumulator >> 4) - (operand >> 4);
-				
-				if (low < 0x0) {
-					low += 0xa;
-					high -= 0x1;
-				}
-				if (high < 0x0) {
-					high += 0xa;
-					clear_flag(cpu->status, MCS6507_STATUS_CARRY);
-				} else {
-					add_flag(cpu->status, MCS6507_STATUS_CARRY);
-				}
-				
-				// high * 0x10 + low
-				result = (high << 4) | (low & 0x0f);
-			}
-			
-			cpu->accumulator = result & 0xff;
-			break;
-		}
-			
-			// MARK: sec
-		case 0x38:
-			set_flag(cpu->status, MCS6507_STATUS_CARRY, true);
-			break;
-			
-			// MARK: sed
-		case 0xf8:
-			set_flag(cpu->status, MCS6507_STATUS_DECIMAL_MODE, true);
-			break;
-			
-			// MARK: sei
-		case 0x78:
-			set_flag(cpu->status, MCS6507_STATUS_INTERRUPT_DISABLE, true);
-			break;
-			
-			// MARK: sta
-		case 0x81: case 0x85: case 0x8d: case 0x91: case 0x95: case 0x99: case 0x9d:
-			cpu->write_bus(cpu->bus, operand_address, cpu->accumulator);
-			break;
-			
-			// MARK: stx
-		case 0x86: case 0x8e: case 0x96:
-			cpu->write_bus(cpu->bus, operand_address, cpu->x);
-			break;
-			
-			// MARK: sty
-		case 0x84: case 0x8c: case 0x94:
-			cpu->write_bus(cpu->bus, operand_address, cpu->y);
-			break;
-			
-			// MARK: tax
-		case 0xaa:
-			cpu->x = cpu->accumulator;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->x == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->x & 0x80);
-			break;
-			
-			// MARK: tay
-		case 0xa8:
-			cpu->y = cpu->accumulator;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->y == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->y & 0x80);
-			break;
-			
-			// MARK: tsx
-		case 0xba:
-			cpu->x = cpu->stack_pointer;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->x == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->x & 0x80);
-			break;
-			
-			// MARK: txa
-		case 0x8a:
-			cpu->accumulator = cpu->x;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-			
-			// MARK: txs
-		case 0x9a:
-			cpu->stack_pointer = cpu->x;
-			break;
-			
-			// MARK: tya
-		case 0x98:
-			cpu->accumulator = cpu->y;
-			set_flag(cpu->status, MCS6507_STATUS_ZERO, cpu->accumulator == 0);
-			set_flag(cpu->status, MCS6507_STATUS_NEGATIVE, cpu->accumulator & 0x80);
-			break;
-			
-		default:
-			printf("Unknown operation code: %02x.\n", cpu->operation.code);
-			break;
-	}
+
+// MARK: -
+int racer_mcs6507_get_status(const racer_mcs6507 *cpu) {
+	return get_status(cpu);
 }
 
 void racer_mcs6507_reset(racer_mcs6507 *cpu) {
-	// reset internal state
-	add_flag(cpu->status, MCS6507_STATUS_INTERRUPT_DISABLE);
+	// reset internal state, with zero and negative flags taken from
+	// the unpredictable status rather than results
+	set_status(cpu, cpu->status | MCS6507_STATUS_INTERRUPT_DISABLE);
 	cpu->stack_pointer = 0xfd;
 	cpu->program_counter = read_address(cpu, 0xfffc);
 	
 	// decode first operation
-	decode_operation(cpu);
+	racer_mcs6507_decode_operation(cpu);
 	cpu->operation_clock = 0;
 }
 
@@ -908,12 +224,98 @@ void racer_mcs6507_advance_clock(racer_mcs6507 *cpu) {
 	cpu->operation_clock += 1;
 	
 	if (cpu->operation_clock == cpu->operation.duration) {
-		// execute current operation
-		cpu->program_counter += cpu->operation.length;
-		execute_decoded_operation(cpu);
-		
-		// decode next operation
-		cpu->operation_clock = 0;
-		decode_operation(cpu);
+		racer_mcs6507_complete_operation(cpu);
+	}
+}
+
+void racer_mcs6507_complete_operation(racer_mcs6507 *cpu) {
+	// execute current operation
+	cpu->program_counter += cpu->operation.length;
+	execute_decoded_operation(cpu);
+	
+	// decode next operation
+	cpu->operation_clock = 0;
+	racer_mcs6507_decode_operation(cpu);
+}
+
+void racer_mcs6507_complete_switched_operation(racer_mcs6507 *cpu) {
+	cpu->program_counter += cpu->operation.length;
+	execute_switched_operation(cpu);
+	
+	cpu->operation_clock = 0;
+	racer_mcs6507_decode_operation(cpu);
+}
+
+
+// MARK: -
+// MARK: Polling loops
+
+bool racer_mcs6507_get_polling_loop(const racer_mcs6507 *cpu, racer_mcs6507_polling_loop *loop) {
+	const predecoded *read = cpu->read_predecoded(cpu->bus, cpu->program_counter);
+	if (read == NULL || read->addressing != ADDRESSING_ABSOLUTE || cpu->operation_clock != 0) {
+		return false;
+	}
+	
+	// loop must only read the bus, and leave MPU registers the same, when
+	// repeated with the same data
+	switch (operation_formats[read->code].operation) {
+		case OPERATION_AND:
+		case OPERATION_BIT:
+		case OPERATION_CMP:
+		case OPERATION_CPX:
+		case OPERATION_CPY:
+		case OPERATION_LDA:
+		case OPERATION_LDX:
+		case OPERATION_LDY:
+		case OPERATION_ORA:
+			break;
+		default:
+			return false;
+	}
+	
+	// loop must branch back to the read operation
+	const int branch_address = cpu->program_counter + read->length;
+	const predecoded *branch = cpu->read_predecoded(cpu->bus, branch_address);
+	if (branch == NULL || operation_formats[branch->code].operation != OPERATION_BRANCH) {
+		return false;
 	}
+	
+	const int next_address = branch_address + branch->length;
+	const int offset = branch->operand;
+	const int offset_address = next_address + ((offset & 0x80) ? offset - 0x100 : offset);
+	if (offset_address != cpu->program_counter) {
+		return false;
+	}
+	
+	*loop = (racer_mcs6507_polling_loop){
+		.address = read->operand,
+		.read_cycle = read->duration,
+		.duration = read->duration + branch->duration + (is_same_page(next_address, offset_address) ? 1 : 2),
+		.read_code = read->code,
+		.branch_code = branch->code
+	};
+	return true;
+}
+
+/// Reads data, which the bus of a polling loop iteration points to.
+static uint8_t read_polled_data(void *bus, int address) {
+	return *(const uint8_t *)bus;
+}
+
+bool racer_mcs6507_repeat_polling_loop(racer_mcs6507 *cpu, const racer_mcs6507_polling_loop *loop, uint8_t data) {
+	// run read operation on a copy of MPU, which reads the specified data
+	// from the bus
+	racer_mcs6507 polled = *cpu;
+	polled.bus = &data;
+	polled.read_bus = read_polled_data;
+	execute_handlers[operation_formats[loop->read_code].operation](&polled, loop->address);
+	
+	if (!is_branch_taken(&polled, loop->branch_code)) {
+		return false;
+	}
+	
+	polled.bus = cpu->bus;
+	polled.read_bus = cpu->read_bus;
+	*cpu = polled;
+	return true;
 }
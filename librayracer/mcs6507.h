@@ -18,6 +18,24 @@ typedef struct {
 	int length;
 } decoded;
 
+/// An operation, decoded ahead of time from read-only memory.
+///
+/// Predecoded operation holds everything about an operation, which does not depend on MPU
+/// state: its code, addressing mode, length, base duration and the number of extra cycles taken
+/// when indexing crosses page boundary. An operation with 0 length is not predecoded.
+///
+/// Block length is the number of operations from this one to the end of its basic block, which ends
+/// with an operation changing control flow or before an operation, which is not predecoded.
+typedef struct {
+	uint8_t code;
+	uint8_t addressing;
+	uint8_t length;
+	uint8_t duration;
+	uint8_t page_cycles;
+	uint8_t block_length;
+	uint16_t operand;
+} predecoded;
+
 typedef enum {
 	MCS6507_STATUS_CARRY = 1<<0,
 	MCS6507_STATUS_ZERO = 1<<1,
@@ -36,18 +54,36 @@ typedef struct {
 	
 	bool is_ready;
 	
+	/// Status flags, except for zero and negative ones, which are evaluated lazily from the results of
+	/// the last operations setting them; use `racer_mcs6507_get_status` to read all status flags.
 	int status;
+	int zero_result;
+	int negative_result;
+	
 	int stack_pointer;
 	int program_counter;
 	
 	void *bus;
 	uint8_t (*read_bus)(void *bus, int address);
 	void (*write_bus)(void *bus, int address, uint8_t data);
+	const predecoded *(*read_predecoded)(void *bus, int address);
 	
 	decoded operation;
 	int operation_clock;
 } racer_mcs6507;
 
+/// Handlers, which run a predecoded operation without decoding it.
+typedef struct {
+	/// Executes the operation with the specified effective address.
+	void (*execute)(racer_mcs6507 *cpu, int address);
+	
+	/// Resolves effective address and duration of the operation and makes it the current one.
+	void (*resolve)(racer_mcs6507 *cpu, const predecoded *operation);
+} racer_mcs6507_handlers;
+
+/// Returns status flags of the specified MCS6507 chip.
+int racer_mcs6507_get_status(const racer_mcs6507 *cpu);
+
 /// Resets the specified MCS6507 chip.
 ///
 /// Resetting the chip sets Interrupt Disable status flag, stack pointer to 0xfd and progam counter
@@ -56,7 +92,71 @@ typedef struct {
 /// This function is equivalent to pulling RES line low for 6 clock cycles in actual hardware.
 void racer_mcs6507_reset(racer_mcs6507 *cpu);
 
+/// Predecodes operation at the start of the specified memory, without reading past its specified size.
+///
+/// Returns `false` when operation code is unknown or the operation does not fit in memory.
+bool racer_mcs6507_predecode(const uint8_t *memory, int size, predecoded *operation);
+
+/// Returns handlers of the specified predecoded operation.
+racer_mcs6507_handlers racer_mcs6507_get_handlers(const predecoded *operation);
+
+/// `true` when the specified operation changes control flow (i.e. branches, jumps, calls or returns
+/// from a subroutine or an interrupt); `false` otherwise.
+bool racer_mcs6507_is_control_flow(const predecoded *operation);
+
+/// Decodes operation at the current program counter and makes it the current one.
+///
+/// Operations in read-only memory are decoded from their predecoded form; all others are decoded
+/// by reading operation code and operands from the bus.
+void racer_mcs6507_decode_operation(racer_mcs6507 *cpu);
+
 /// Advanced MCS6507 chip clock by 1 full (2-phase) cycle.
 void racer_mcs6507_advance_clock(racer_mcs6507 *cpu);
 
+/// Advances MCS6507 chip clock to the last cycle of the current operation and executes it.
+///
+/// This function is equivalent to advancing the clock by 1 cycle until the current operation completes,
+/// while the chip remains ready.
+void racer_mcs6507_complete_operation(racer_mcs6507 *cpu);
+
+/// Same as `racer_mcs6507_complete_operation`, but dispatches the operation through a switch over
+/// its type, as when the compiler does not support computed goto; lets benchmarks compare both ways
+/// of dispatch within the same build.
+void racer_mcs6507_complete_switched_operation(racer_mcs6507 *cpu);
+
+
+// MARK: -
+// MARK: Polling loops
+
+/// A loop of 2 operations, which reads an absolute address and branches back to the read, depending
+/// on the read data.
+///
+/// Repeating an iteration of the loop with the same data leaves MPU in the same state (e.g. loading
+/// or comparing the data, but not adding it).
+typedef struct {
+	/// The polled address.
+	int address;
+	/// The cycle of an iteration, on which the polled address is read (i.e. the last cycle of the read
+	/// operation).
+	int read_cycle;
+	/// The number of cycles of an iteration, which branches back.
+	int duration;
+	
+	int read_code;
+	int branch_code;
+} racer_mcs6507_polling_loop;
+
+/// Returns whether the current operation of the specified MCS6507 chip starts a polling loop, before
+/// any of its cycles advance; `loop` is set to such loop.
+///
+/// Only predecoded operations make up polling loops, so that code of the loop cannot change while it
+/// runs.
+bool racer_mcs6507_get_polling_loop(const racer_mcs6507 *cpu, racer_mcs6507_polling_loop *loop);
+
+/// Runs an iteration of the specified polling loop, in which the polled address reads the specified
+/// data, when the iteration branches back; does nothing otherwise.
+///
+/// Returns whether the iteration ran.
+bool racer_mcs6507_repeat_polling_loop(racer_mcs6507 *cpu, const racer_mcs6507_polling_loop *loop, uint8_t data);
+
 #endif /* mcs6507_h */
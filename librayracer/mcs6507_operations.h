@@ -0,0 +1,932 @@
+//
+//  mcs6507_operations.h
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#ifndef mcs6507_operations_h
+#define mcs6507_operations_h
+
+#include "mcs6507.h"
+#include "flags.h"
+
+// NOTE: formats, addressing and execution of MCS6507 operations are defined
+// inline, so that code translated ahead of time runs the same operations
+// as the interpreter, without calling through operation handlers; this
+// header is private to librayracer and translated code
+
+// MARK: Convenience functionality
+
+/// A memory address at the specified page and offset.
+#define address(high, low) \
+(((high) << 8) | (low))
+
+/// `true` when both of the specified memory addresses are on the same page; `false` otherwise.
+#define is_same_page(address1, address2) \
+(((address1) >> 8) == ((address2) >> 8))
+
+
+// MARK: -
+// MARK: Memory addressing
+
+/// Reads address at the specified address in memory.
+static inline int read_address(racer_mcs6507 *cpu, int address) {
+	const int low = cpu->read_bus(cpu->bus, address);
+	const int high = cpu->read_bus(cpu->bus, address + 0x1);
+	
+	return address(high, low);
+}
+
+/// Reads effective address, using indirect addressing mode, with the specified indirect address.
+static inline int read_indirect_address(racer_mcs6507 *cpu, int address) {
+	const int low = cpu->read_bus(cpu->bus, address);
+	
+	// NOTE: MCS6507 has a bug in indirect addressing mode; this mode is used
+	// only in JMP instruction;
+	// when resolved jump address is at the end of a memory page, high byte of
+	// the effective jump address will not be read from (low byte address + 1),
+	// but from the beginning of that memory page instead;
+	// for instance, when jump address is at address $4aff, MCS6507 will read
+	// effective jump address:
+	//	- low byte from $4aff
+	//	- high byte from $4a00 instead of ($4aff + 1) = $4b00
+	address = (address & 0xff00) | ((address + 0x1) & 0xff);
+	const int high = cpu->read_bus(cpu->bus, address);
+	
+	return address(high, low);
+}
+
+/// Reads effective address, using x-indexed indirect addressing mode, with the specified 0-page
+/// base address.
+static inline int read_indirect_x_indexed_address(racer_mcs6507 *cpu, int address) {
+	// apply indexing
+	address = address + cpu->x;
+	
+	const int low = cpu->read_bus(cpu->bus, address & 0xff);
+	const int high = cpu->read_bus(cpu->bus, (address + 0x1) & 0xff);
+	return address(high, low);
+}
+
+/// Reads effective address, using indirect y-indexed addressing mode, with the specified 0-page
+/// indirect address.
+///
+/// Additionally returns whether indexing crosses page boundary.
+static inline int read_indirect_y_indexed_address(racer_mcs6507 *cpu, int address, bool *is_page_crossed) {
+	// read base address
+	const int low = cpu->read_bus(cpu->bus, address);
+	const int high = cpu->read_bus(cpu->bus, (address + 0x1) & 0xff);
+	address = address(high, low);
+	
+	// apply indexing
+	int indexed_address = address + cpu->y;
+	*is_page_crossed = !is_same_page(address, indexed_address);
+	return indexed_address;
+}
+
+
+// MARK: -
+// MARK: Stack management
+
+/// Pushes the specified value onto stack and updates the stack pointer.
+static inline void push_stack(racer_mcs6507 *cpu, int data) {
+	const int address = cpu->stack_pointer + 0x0100;
+	cpu->write_bus(cpu->bus, address, data);
+	cpu->stack_pointer = (cpu->stack_pointer - 0x1) & 0xff;
+}
+
+/// Pulls the last pushed value from the stack and updates the stack pointer.
+static inline int pull_stack(racer_mcs6507 *cpu) {
+	cpu->stack_pointer = (cpu->stack_pointer + 0x1) & 0xff;
+	
+	const int address = cpu->stack_pointer + 0x0100;
+	return cpu->read_bus(cpu->bus, address);
+}
+
+
+// MARK: -
+// MARK: Status flags
+
+/// Sets zero and negative status flags from the specified operation result.
+///
+/// Both flags are evaluated lazily from the result, when status is read: zero flag is set when the low
+/// byte of the result is 0, and negative flag when its bit 7 is set.
+static inline void set_result(racer_mcs6507 *cpu, int result) {
+	cpu->zero_result = result;
+	cpu->negative_result = result;
+}
+
+/// Returns status of the specified MPU, with zero and negative flags evaluated from the last result.
+static inline int get_status(const racer_mcs6507 *cpu) {
+	int status = cpu->status & ~(MCS6507_STATUS_ZERO | MCS6507_STATUS_NEGATIVE);
+	set_flag(status, MCS6507_STATUS_ZERO, (cpu->zero_result & 0xff) == 0);
+	set_flag(status, MCS6507_STATUS_NEGATIVE, cpu->negative_result & 0x80);
+	
+	return status;
+}
+
+/// Sets status of the specified MPU, including its zero and negative flags.
+static inline void set_status(racer_mcs6507 *cpu, int status) {
+	cpu->status = status;
+	cpu->zero_result = is_flag_set(status, MCS6507_STATUS_ZERO) ? 0x00 : 0x01;
+	cpu->negative_result = status & MCS6507_STATUS_NEGATIVE;
+}
+
+
+// MARK: -
+// MARK: Operation decoding
+
+/// Addressing modes of MCS6507 operations.
+typedef enum {
+	ADDRESSING_UNKNOWN,
+	ADDRESSING_IMPLIED,
+	ADDRESSING_IMMEDIATE,
+	ADDRESSING_RELATIVE,
+	ADDRESSING_0_PAGE,
+	ADDRESSING_0_PAGE_X_INDEXED,
+	ADDRESSING_0_PAGE_Y_INDEXED,
+	ADDRESSING_ABSOLUTE,
+	ADDRESSING_X_INDEXED,
+	ADDRESSING_Y_INDEXED,
+	ADDRESSING_INDIRECT,
+	ADDRESSING_INDIRECT_X_INDEXED,
+	ADDRESSING_INDIRECT_Y_INDEXED
+} addressing_mode;
+
+/// All operations of MCS6507, as (handler name, operation type name) pairs.
+#define OPERATIONS(OPERATION) \
+	OPERATION(adc, ADC) \
+	OPERATION(and, AND) \
+	OPERATION(asl_accumulator, ASL_ACCUMULATOR) \
+	OPERATION(asl, ASL) \
+	OPERATION(branch, BRANCH) \
+	OPERATION(bit, BIT) \
+	OPERATION(brk, BRK) \
+	OPERATION(clc, CLC) \
+	OPERATION(cld, CLD) \
+	OPERATION(cli, CLI) \
+	OPERATION(clv, CLV) \
+	OPERATION(cmp, CMP) \
+	OPERATION(cpx, CPX) \
+	OPERATION(cpy, CPY) \
+	OPERATION(dec, DEC) \
+	OPERATION(dex, DEX) \
+	OPERATION(dey, DEY) \
+	OPERATION(eor, EOR) \
+	OPERATION(inc, INC) \
+	OPERATION(inx, INX) \
+	OPERATION(iny, INY) \
+	OPERATION(jmp, JMP) \
+	OPERATION(jsr, JSR) \
+	OPERATION(lda, LDA) \
+	OPERATION(ldx, LDX) \
+	OPERATION(ldy, LDY) \
+	OPERATION(lsr_accumulator, LSR_ACCUMULATOR) \
+	OPERATION(lsr, LSR) \
+	OPERATION(nop, NOP) \
+	OPERATION(ora, ORA) \
+	OPERATION(pha, PHA) \
+	OPERATION(php, PHP) \
+	OPERATION(pla, PLA) \
+	OPERATION(plp, PLP) \
+	OPERATION(rol_accumulator, ROL_ACCUMULATOR) \
+	OPERATION(rol, ROL) \
+	OPERATION(ror_accumulator, ROR_ACCUMULATOR) \
+	OPERATION(ror, ROR) \
+	OPERATION(rti, RTI) \
+	OPERATION(rts, RTS) \
+	OPERATION(sbc, SBC) \
+	OPERATION(sec, SEC) \
+	OPERATION(sed, SED) \
+	OPERATION(sei, SEI) \
+	OPERATION(sta, STA) \
+	OPERATION(stx, STX) \
+	OPERATION(sty, STY) \
+	OPERATION(tax, TAX) \
+	OPERATION(tay, TAY) \
+	OPERATION(tsx, TSX) \
+	OPERATION(txa, TXA) \
+	OPERATION(txs, TXS) \
+	OPERATION(tya, TYA)
+
+/// Types of MCS6507 operations.
+typedef enum {
+	OPERATION_UNKNOWN,
+#define OPERATION_TYPE(name, NAME) OPERATION_##NAME,
+	OPERATIONS(OPERATION_TYPE)
+#undef OPERATION_TYPE
+	OPERATION_COUNT
+} operation_type;
+
+/// Format of an operation, which does not depend on its operand or MPU state.
+typedef struct {
+	uint8_t operation;
+	uint8_t addressing;
+	uint8_t length;
+	uint8_t duration;
+	
+	/// The number of extra CPU cycles it takes to resolve indexed effective address, when indexing
+	/// crosses page boundary.
+	uint8_t page_cycles;
+} operation_format;
+
+/// Formats of all operations, indexed by operation code; unknown operation codes have 0 length.
+static const operation_format operation_formats[0x100] = {
+	// MARK: implied addressing
+	[0x18] = {OPERATION_CLC, ADDRESSING_IMPLIED, 1, 2}, [0x38] = {OPERATION_SEC, ADDRESSING_IMPLIED, 1, 2},
+	[0x58] = {OPERATION_CLI, ADDRESSING_IMPLIED, 1, 2}, [0xb8] = {OPERATION_CLV, ADDRESSING_IMPLIED, 1, 2},
+	[0xd8] = {OPERATION_CLD, ADDRESSING_IMPLIED, 1, 2}, [0x78] = {OPERATION_SEI, ADDRESSING_IMPLIED, 1, 2},
+	[0x88] = {OPERATION_DEY, ADDRESSING_IMPLIED, 1, 2}, [0xa8] = {OPERATION_TAY, ADDRESSING_IMPLIED, 1, 2},
+	[0x98] = {OPERATION_TYA, ADDRESSING_IMPLIED, 1, 2}, [0xc8] = {OPERATION_INY, ADDRESSING_IMPLIED, 1, 2},
+	[0xe8] = {OPERATION_INX, ADDRESSING_IMPLIED, 1, 2}, [0xf8] = {OPERATION_SED, ADDRESSING_IMPLIED, 1, 2},
+	[0x0a] = {OPERATION_ASL_ACCUMULATOR, ADDRESSING_IMPLIED, 1, 2}, [0x2a] = {OPERATION_ROL_ACCUMULATOR, ADDRESSING_IMPLIED, 1, 2},
+	[0x4a] = {OPERATION_LSR_ACCUMULATOR, ADDRESSING_IMPLIED, 1, 2}, [0x6a] = {OPERATION_ROR_ACCUMULATOR, ADDRESSING_IMPLIED, 1, 2},
+	[0x8a] = {OPERATION_TXA, ADDRESSING_IMPLIED, 1, 2}, [0x9a] = {OPERATION_TXS, ADDRESSING_IMPLIED, 1, 2},
+	[0xaa] = {OPERATION_TAX, ADDRESSING_IMPLIED, 1, 2}, [0xba] = {OPERATION_TSX, ADDRESSING_IMPLIED, 1, 2},
+	[0xca] = {OPERATION_DEX, ADDRESSING_IMPLIED, 1, 2}, [0xea] = {OPERATION_NOP, ADDRESSING_IMPLIED, 1, 2},
+	[0x08] = {OPERATION_PHP, ADDRESSING_IMPLIED, 1, 3}, [0x48] = {OPERATION_PHA, ADDRESSING_IMPLIED, 1, 3},
+	[0x28] = {OPERATION_PLP, ADDRESSING_IMPLIED, 1, 4}, [0x68] = {OPERATION_PLA, ADDRESSING_IMPLIED, 1, 4},
+	[0x40] = {OPERATION_RTI, ADDRESSING_IMPLIED, 1, 6}, [0x60] = {OPERATION_RTS, ADDRESSING_IMPLIED, 1, 6},
+	// NOTE: even though BRK instruction length is 1 byte, return address
+	// on the stack is program counter + 2
+	[0x00] = {OPERATION_BRK, ADDRESSING_IMPLIED, 2, 7},
+	
+	// MARK: immediate addressing
+	[0xa2] = {OPERATION_LDX, ADDRESSING_IMMEDIATE, 2, 2}, [0x09] = {OPERATION_ORA, ADDRESSING_IMMEDIATE, 2, 2},
+	[0x29] = {OPERATION_AND, ADDRESSING_IMMEDIATE, 2, 2}, [0x49] = {OPERATION_EOR, ADDRESSING_IMMEDIATE, 2, 2},
+	[0x69] = {OPERATION_ADC, ADDRESSING_IMMEDIATE, 2, 2}, [0xa9] = {OPERATION_LDA, ADDRESSING_IMMEDIATE, 2, 2},
+	[0xc9] = {OPERATION_CMP, ADDRESSING_IMMEDIATE, 2, 2}, [0xe9] = {OPERATION_SBC, ADDRESSING_IMMEDIATE, 2, 2},
+	[0xa0] = {OPERATION_LDY, ADDRESSING_IMMEDIATE, 2, 2}, [0xe0] = {OPERATION_CPX, ADDRESSING_IMMEDIATE, 2, 2},
+	[0xc0] = {OPERATION_CPY, ADDRESSING_IMMEDIATE, 2, 2},
+	
+	// MARK: relative addressing
+	[0x10] = {OPERATION_BRANCH, ADDRESSING_RELATIVE, 2, 2}, [0x30] = {OPERATION_BRANCH, ADDRESSING_RELATIVE, 2, 2},
+	[0x50] = {OPERATION_BRANCH, ADDRESSING_RELATIVE, 2, 2}, [0x70] = {OPERATION_BRANCH, ADDRESSING_RELATIVE, 2, 2},
+	[0x90] = {OPERATION_BRANCH, ADDRESSING_RELATIVE, 2, 2}, [0xb0] = {OPERATION_BRANCH, ADDRESSING_RELATIVE, 2, 2},
+	[0xd0] = {OPERATION_BRANCH, ADDRESSING_RELATIVE, 2, 2}, [0xf0] = {OPERATION_BRANCH, ADDRESSING_RELATIVE, 2, 2},
+	
+	// MARK: 0-page absolute addressing
+	[0x24] = {OPERATION_BIT, ADDRESSING_0_PAGE, 2, 3}, [0x84] = {OPERATION_STY, ADDRESSING_0_PAGE, 2, 3},
+	[0xa4] = {OPERATION_LDY, ADDRESSING_0_PAGE, 2, 3}, [0xc4] = {OPERATION_CPY, ADDRESSING_0_PAGE, 2, 3},
+	[0xe4] = {OPERATION_CPX, ADDRESSING_0_PAGE, 2, 3}, [0x05] = {OPERATION_ORA, ADDRESSING_0_PAGE, 2, 3},
+	[0x25] = {OPERATION_AND, ADDRESSING_0_PAGE, 2, 3}, [0x45] = {OPERATION_EOR, ADDRESSING_0_PAGE, 2, 3},
+	[0x65] = {OPERATION_ADC, ADDRESSING_0_PAGE, 2, 3}, [0x85] = {OPERATION_STA, ADDRESSING_0_PAGE, 2, 3},
+	[0xa5] = {OPERATION_LDA, ADDRESSING_0_PAGE, 2, 3}, [0xc5] = {OPERATION_CMP, ADDRESSING_0_PAGE, 2, 3},
+	[0xe5] = {OPERATION_SBC, ADDRESSING_0_PAGE, 2, 3}, [0xa6] = {OPERATION_LDX, ADDRESSING_0_PAGE, 2, 3},
+	[0x86] = {OPERATION_STX, ADDRESSING_0_PAGE, 2, 3},
+	[0x06] = {OPERATION_ASL, ADDRESSING_0_PAGE, 2, 5}, [0x26] = {OPERATION_ROL, ADDRESSING_0_PAGE, 2, 5},
+	[0x46] = {OPERATION_LSR, ADDRESSING_0_PAGE, 2, 5}, [0x66] = {OPERATION_ROR, ADDRESSING_0_PAGE, 2, 5},
+	[0xc6] = {OPERATION_DEC, ADDRESSING_0_PAGE, 2, 5}, [0xe6] = {OPERATION_INC, ADDRESSING_0_PAGE, 2, 5},
+	
+	// MARK: 0-page x-indexed addressing
+	[0x94] = {OPERATION_STY, ADDRESSING_0_PAGE_X_INDEXED, 2, 4}, [0xb4] = {OPERATION_LDY, ADDRESSING_0_PAGE_X_INDEXED, 2, 4},
+	[0x15] = {OPERATION_ORA, ADDRESSING_0_PAGE_X_INDEXED, 2, 4}, [0x35] = {OPERATION_AND, ADDRESSING_0_PAGE_X_INDEXED, 2, 4},
+	[0x55] = {OPERATION_EOR, ADDRESSING_0_PAGE_X_INDEXED, 2, 4}, [0x75] = {OPERATION_ADC, ADDRESSING_0_PAGE_X_INDEXED, 2, 4},
+	[0x95] = {OPERATION_STA, ADDRESSING_0_PAGE_X_INDEXED, 2, 4}, [0xb5] = {OPERATION_LDA, ADDRESSING_0_PAGE_X_INDEXED, 2, 4},
+	[0xd5] = {OPERATION_CMP, ADDRESSING_0_PAGE_X_INDEXED, 2, 4}, [0xf5] = {OPERATION_SBC, ADDRESSING_0_PAGE_X_INDEXED, 2, 4},
+	[0x16] = {OPERATION_ASL, ADDRESSING_0_PAGE_X_INDEXED, 2, 6}, [0x36] = {OPERATION_ROL, ADDRESSING_0_PAGE_X_INDEXED, 2, 6},
+	[0x56] = {OPERATION_LSR, ADDRESSING_0_PAGE_X_INDEXED, 2, 6}, [0x76] = {OPERATION_ROR, ADDRESSING_0_PAGE_X_INDEXED, 2, 6},
+	[0xd6] = {OPERATION_DEC, ADDRESSING_0_PAGE_X_INDEXED, 2, 6}, [0xf6] = {OPERATION_INC, ADDRESSING_0_PAGE_X_INDEXED, 2, 6},
+	
+	// MARK: 0-page y-indexed addressing
+	[0x96] = {OPERATION_STX, ADDRESSING_0_PAGE_Y_INDEXED, 2, 4}, [0xb6] = {OPERATION_LDX, ADDRESSING_0_PAGE_Y_INDEXED, 2, 4},
+	
+	// MARK: absolute addressing
+	[0x4c] = {OPERATION_JMP, ADDRESSING_ABSOLUTE, 3, 3},
+	[0x2c] = {OPERATION_BIT, ADDRESSING_ABSOLUTE, 3, 4}, [0x8c] = {OPERATION_STY, ADDRESSING_ABSOLUTE, 3, 4},
+	[0xac] = {OPERATION_LDY, ADDRESSING_ABSOLUTE, 3, 4}, [0xcc] = {OPERATION_CPY, ADDRESSING_ABSOLUTE, 3, 4},
+	[0xec] = {OPERATION_CPX, ADDRESSING_ABSOLUTE, 3, 4}, [0x0d] = {OPERATION_ORA, ADDRESSING_ABSOLUTE, 3, 4},
+	[0x2d] = {OPERATION_AND, ADDRESSING_ABSOLUTE, 3, 4}, [0x4d] = {OPERATION_EOR, ADDRESSING_ABSOLUTE, 3, 4},
+	[0x6d] = {OPERATION_ADC, ADDRESSING_ABSOLUTE, 3, 4}, [0x8d] = {OPERATION_STA, ADDRESSING_ABSOLUTE, 3, 4},
+	[0xad] = {OPERATION_LDA, ADDRESSING_ABSOLUTE, 3, 4}, [0xcd] = {OPERATION_CMP, ADDRESSING_ABSOLUTE, 3, 4},
+	[0xed] = {OPERATION_SBC, ADDRESSING_ABSOLUTE, 3, 4}, [0x8e] = {OPERATION_STX, ADDRESSING_ABSOLUTE, 3, 4},
+	[0xae] = {OPERATION_LDX, ADDRESSING_ABSOLUTE, 3, 4},
+	[0x20] = {OPERATION_JSR, ADDRESSING_ABSOLUTE, 3, 6}, [0x0e] = {OPERATION_ASL, ADDRESSING_ABSOLUTE, 3, 6},
+	[0x2e] = {OPERATION_ROL, ADDRESSING_ABSOLUTE, 3, 6}, [0x4e] = {OPERATION_LSR, ADDRESSING_ABSOLUTE, 3, 6},
+	[0x6e] = {OPERATION_ROR, ADDRESSING_ABSOLUTE, 3, 6}, [0xce] = {OPERATION_DEC, ADDRESSING_ABSOLUTE, 3, 6},
+	[0xee] = {OPERATION_INC, ADDRESSING_ABSOLUTE, 3, 6},
+	
+	// MARK: absolute x-indexed addressing
+	[0xbc] = {OPERATION_LDY, ADDRESSING_X_INDEXED, 3, 4, 1}, [0x1d] = {OPERATION_ORA, ADDRESSING_X_INDEXED, 3, 4, 1},
+	[0x3d] = {OPERATION_AND, ADDRESSING_X_INDEXED, 3, 4, 1}, [0x5d] = {OPERATION_EOR, ADDRESSING_X_INDEXED, 3, 4, 1},
+	[0x7d] = {OPERATION_ADC, ADDRESSING_X_INDEXED, 3, 4, 1}, [0xbd] = {OPERATION_LDA, ADDRESSING_X_INDEXED, 3, 4, 1},
+	[0xdd] = {OPERATION_CMP, ADDRESSING_X_INDEXED, 3, 4, 1}, [0xfd] = {OPERATION_SBC, ADDRESSING_X_INDEXED, 3, 4, 1},
+	[0x9d] = {OPERATION_STA, ADDRESSING_X_INDEXED, 3, 5},
+	[0x1e] = {OPERATION_ASL, ADDRESSING_X_INDEXED, 3, 7}, [0x3e] = {OPERATION_ROL, ADDRESSING_X_INDEXED, 3, 7},
+	[0x5e] = {OPERATION_LSR, ADDRESSING_X_INDEXED, 3, 7}, [0x7e] = {OPERATION_ROR, ADDRESSING_X_INDEXED, 3, 7},
+	[0xde] = {OPERATION_DEC, ADDRESSING_X_INDEXED, 3, 7}, [0xfe] = {OPERATION_INC, ADDRESSING_X_INDEXED, 3, 7},
+	
+	// MARK: absolute y-indexed addressing
+	[0x19] = {OPERATION_ORA, ADDRESSING_Y_INDEXED, 3, 4, 1}, [0x39] = {OPERATION_AND, ADDRESSING_Y_INDEXED, 3, 4, 1},
+	[0x59] = {OPERATION_EOR, ADDRESSING_Y_INDEXED, 3, 4, 1}, [0x79] = {OPERATION_ADC, ADDRESSING_Y_INDEXED, 3, 4, 1},
+	[0xb9] = {OPERATION_LDA, ADDRESSING_Y_INDEXED, 3, 4, 1}, [0xd9] = {OPERATION_CMP, ADDRESSING_Y_INDEXED, 3, 4, 1},
+	[0xf9] = {OPERATION_SBC, ADDRESSING_Y_INDEXED, 3, 4, 1}, [0xbe] = {OPERATION_LDX, ADDRESSING_Y_INDEXED, 3, 4, 1},
+	[0x99] = {OPERATION_STA, ADDRESSING_Y_INDEXED, 3, 5},
+	
+	// MARK: indirect addressing
+	[0x6c] = {OPERATION_JMP, ADDRESSING_INDIRECT, 3, 5},
+	
+	// MARK: indirect x-indexed addressing
+	[0x61] = {OPERATION_ADC, ADDRESSING_INDIRECT_X_INDEXED, 2, 6}, [0x21] = {OPERATION_AND, ADDRESSING_INDIRECT_X_INDEXED, 2, 6},
+	[0xc1] = {OPERATION_CMP, ADDRESSING_INDIRECT_X_INDEXED, 2, 6}, [0x41] = {OPERATION_EOR, ADDRESSING_INDIRECT_X_INDEXED, 2, 6},
+	[0xa1] = {OPERATION_LDA, ADDRESSING_INDIRECT_X_INDEXED, 2, 6}, [0x01] = {OPERATION_ORA, ADDRESSING_INDIRECT_X_INDEXED, 2, 6},
+	[0xe1] = {OPERATION_SBC, ADDRESSING_INDIRECT_X_INDEXED, 2, 6}, [0x81] = {OPERATION_STA, ADDRESSING_INDIRECT_X_INDEXED, 2, 6},
+	
+	// MARK: indirect y-indexed addressing
+	[0x11] = {OPERATION_ORA, ADDRESSING_INDIRECT_Y_INDEXED, 2, 5, 1}, [0x31] = {OPERATION_AND, ADDRESSING_INDIRECT_Y_INDEXED, 2, 5, 1},
+	[0x51] = {OPERATION_EOR, ADDRESSING_INDIRECT_Y_INDEXED, 2, 5, 1}, [0x71] = {OPERATION_ADC, ADDRESSING_INDIRECT_Y_INDEXED, 2, 5, 1},
+	[0xb1] = {OPERATION_LDA, ADDRESSING_INDIRECT_Y_INDEXED, 2, 5, 1}, [0xd1] = {OPERATION_CMP, ADDRESSING_INDIRECT_Y_INDEXED, 2, 5, 1},
+	[0xf1] = {OPERATION_SBC, ADDRESSING_INDIRECT_Y_INDEXED, 2, 5, 1},
+	// NOTE: sta with indirect y-indexed addressing always takes 6 clock
+	// cycles
+	[0x91] = {OPERATION_STA, ADDRESSING_INDIRECT_Y_INDEXED, 2, 6}
+};
+
+/// Status flags tested by branch operations, indexed by the 2 most significant bits of operation code.
+static const int branch_flags[4] = {
+	MCS6507_STATUS_NEGATIVE,
+	MCS6507_STATUS_OVERFLOW,
+	MCS6507_STATUS_CARRY,
+	MCS6507_STATUS_ZERO
+};
+
+/// `true` when branch operation with the specified code is taken; `false` otherwise.
+///
+/// Branch operation is taken when the status flag it tests is set or clear, as specified by bit 5 of its
+/// operation code.
+static inline bool is_branch_taken(const racer_mcs6507 *cpu, int code) {
+	const bool is_set = is_flag_set(get_status(cpu), branch_flags[code >> 6]);
+	return is_set == (bool)(code & 0x20);
+}
+
+
+/// Resolves effective address and duration of the specified operation, using its operand and the
+/// current MPU state.
+///
+/// Addressing mode is passed separately from the operation, so that resolution can be specialized
+/// for a constant addressing mode. Operands of relative addressing operations are only read when
+/// the branch is taken, unless the operation is predecoded.
+static inline void resolve_operation(racer_mcs6507 *cpu, const predecoded *operation, int addressing, bool is_predecoded) {
+	const int operand_address = cpu->program_counter + 0x1;
+	int address = operation->operand;
+	int cycles = 0;
+	
+	switch (addressing) {
+		case ADDRESSING_IMPLIED:
+			address = -1;
+			break;
+		
+		case ADDRESSING_IMMEDIATE:
+			address = operand_address;
+			break;
+		
+		case ADDRESSING_RELATIVE:
+			// when branch is not taken, program counter increments to +1
+			// relative to offset operand address
+			address = operand_address + 0x1;
+			
+			if (is_branch_taken(cpu, operation->code)) {
+				const int offset = is_predecoded
+				? operation->operand
+				: cpu->read_bus(cpu->bus, operand_address);
+				
+				// offset address using signed 8 bit offset and check if
+				// offsetting crosses page boundary
+				const int offset_address = address + ((offset & 0x80) ? offset - 0x100 : offset);
+				cycles = is_same_page(address, offset_address) ? 1 : 2;
+				address = offset_address;
+			}
+			break;
+		
+		case ADDRESSING_0_PAGE:
+		case ADDRESSING_ABSOLUTE:
+			break;
+		
+		case ADDRESSING_0_PAGE_X_INDEXED:
+			address = (address + cpu->x) & 0xff;
+			break;
+		
+		case ADDRESSING_0_PAGE_Y_INDEXED:
+			address = (address + cpu->y) & 0xff;
+			break;
+		
+		case ADDRESSING_X_INDEXED: {
+			const int indexed_address = address + cpu->x;
+			cycles = is_same_page(address, indexed_address) ? 0 : operation->page_cycles;
+			address = indexed_address;
+			break;
+		}
+		
+		case ADDRESSING_Y_INDEXED: {
+			const int indexed_address = address + cpu->y;
+			cycles = is_same_page(address, indexed_address) ? 0 : operation->page_cycles;
+			address = indexed_address;
+			break;
+		}
+		
+		case ADDRESSING_INDIRECT:
+			address = read_indirect_address(cpu, address);
+			break;
+		
+		case ADDRESSING_INDIRECT_X_INDEXED:
+			address = read_indirect_x_indexed_address(cpu, address);
+			break;
+		
+		case ADDRESSING_INDIRECT_Y_INDEXED: {
+			bool is_page_crossed;
+			address = read_indirect_y_indexed_address(cpu, address, &is_page_crossed);
+			cycles = is_page_crossed ? operation->page_cycles : 0;
+			break;
+		}
+	}
+	
+	cpu->operation = (decoded){
+		operation->code,
+		address,
+		operation->duration + cycles,
+		operation->length
+	};
+}
+
+
+// MARK: -
+// MARK: Operation execution
+
+/// ADC: add memory to accumulator with carry.
+static inline void execute_adc(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const bool carry = is_flag_set(cpu->status, MCS6507_STATUS_CARRY);
+	
+	int result = cpu->accumulator + operand + carry;
+	const int overflow = (cpu->accumulator ^ result) & (operand ^ result);
+	
+	// NOTE: status flags are set from intermediary result, not
+	// decimal mode corrected one
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, result > 0xff);
+	set_flag(cpu->status, MCS6507_STATUS_OVERFLOW, overflow & 0x80);
+	set_result(cpu, result);
+	
+	if (is_flag_set(cpu->status, MCS6507_STATUS_DECIMAL_MODE)) {
+		// (accumulator % 0x10) + (operand % 0x10)
+		int low = (cpu->accumulator & 0x0f) + (operand & 0x0f) + carry;
+		// (accumulator / 0x10) + (operand / 0x10)
+		int high = (cpu->accumulator >> 4) + (operand >> 4);
+		
+		if (low > 0x9) {
+			low -= 0xa;
+			high += 0x1;
+		}
+		if (high > 0x9) {
+			high -= 0xa;
+			add_flag(cpu->status, MCS6507_STATUS_CARRY);
+		} else {
+			clear_flag(cpu->status, MCS6507_STATUS_CARRY);
+		}
+		
+		// high * 0x10 + low
+		result = (high << 4) | (low & 0x0f);
+	}
+	
+	cpu->accumulator = result & 0xff;
+}
+
+/// AND: AND memory with accumulator.
+static inline void execute_and(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	cpu->accumulator &= operand;
+	
+	set_result(cpu, cpu->accumulator);
+}
+
+/// ASL: shift accumulator left.
+static inline void execute_asl_accumulator(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	const bool carry = cpu->accumulator & 0x80;
+	const int result = (cpu->accumulator << 1) & 0xff;
+	
+	cpu->accumulator = result;
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, carry);
+	set_result(cpu, cpu->accumulator);
+}
+
+/// ASL: shift memory left.
+static inline void execute_asl(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = (operand << 1) & 0xff;
+	
+	cpu->write_bus(cpu->bus, operand_address, result);
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, operand & 0x80);
+	set_result(cpu, result);
+}
+
+/// BCC, BCS, BEQ, BMI, BNE, BPL, BVC, BVS: branch on condition, resolved when the operation is decoded.
+static inline void execute_branch(racer_mcs6507 *cpu, int operand_address) {
+	cpu->program_counter = operand_address;
+}
+
+/// BIT: test memory bits with accumulator.
+static inline void execute_bit(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = operand & cpu->accumulator;
+	
+	set_flag(cpu->status, MCS6507_STATUS_OVERFLOW, operand & 0x40);
+	cpu->negative_result = operand;
+	cpu->zero_result = result;
+}
+
+/// BRK: force break.
+static inline void execute_brk(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	push_stack(cpu, cpu->program_counter >> 8);
+	push_stack(cpu, cpu->program_counter & 0xff);
+	push_stack(cpu, get_status(cpu) | MCS6507_STATUS_BREAK | MCS6507_STATUS_UNUSED);
+	
+	const int low = cpu->read_bus(cpu->bus, 0xfffe);
+	const int high = cpu->read_bus(cpu->bus, 0xffff);
+	cpu->program_counter = address(high, low);
+	
+	add_flag(cpu->status, MCS6507_STATUS_INTERRUPT_DISABLE);
+}
+
+/// CLC: clear carry flag.
+static inline void execute_clc(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, false);
+}
+
+/// CLD: clear decimal mode.
+static inline void execute_cld(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	set_flag(cpu->status, MCS6507_STATUS_DECIMAL_MODE, false);
+}
+
+/// CLI: clear interrupt disable flag.
+static inline void execute_cli(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	set_flag(cpu->status, MCS6507_STATUS_INTERRUPT_DISABLE, false);
+}
+
+/// CLV: clear overflow flag.
+static inline void execute_clv(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	set_flag(cpu->status, MCS6507_STATUS_OVERFLOW, false);
+}
+
+/// CMP: compare memory with accumulator.
+static inline void execute_cmp(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = cpu->accumulator - operand;
+	
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, result >= 0);
+	set_result(cpu, result);
+}
+
+/// CPX: compare memory with index x.
+static inline void execute_cpx(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = cpu->x - operand;
+	
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, result >= 0);
+	set_result(cpu, result);
+}
+
+/// CPY: compare memory with index y.
+static inline void execute_cpy(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = cpu->y - operand;
+	
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, result >= 0);
+	set_result(cpu, result);
+}
+
+/// DEC: decrement memory.
+static inline void execute_dec(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = (operand - 0x1) & 0xff;
+	
+	cpu->write_bus(cpu->bus, operand_address, result);
+	set_result(cpu, result);
+}
+
+/// DEX: decrement index x.
+static inline void execute_dex(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->x = (cpu->x - 0x1) & 0xff;
+	set_result(cpu, cpu->x);
+}
+
+/// DEY: decrement index y.
+static inline void execute_dey(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->y = (cpu->y - 0x1) & 0xff;
+	set_result(cpu, cpu->y);
+}
+
+/// EOR: exclusive-OR memory with accumulator.
+static inline void execute_eor(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	
+	cpu->accumulator ^= operand;
+	set_result(cpu, cpu->accumulator);
+}
+
+/// INC: increment memory.
+static inline void execute_inc(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = (operand + 0x1) & 0xff;
+	
+	cpu->write_bus(cpu->bus, operand_address, result);
+	set_result(cpu, result);
+}
+
+/// INX: increment index x.
+static inline void execute_inx(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->x = (cpu->x + 0x1) & 0xff;
+	set_result(cpu, cpu->x);
+}
+
+/// INY: increment index y.
+static inline void execute_iny(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->y = (cpu->y + 0x1) & 0xff;
+	set_result(cpu, cpu->y);
+}
+
+/// JMP: jump to address.
+static inline void execute_jmp(racer_mcs6507 *cpu, int operand_address) {
+	cpu->program_counter = operand_address;
+}
+
+/// JSR: jump to subroutine.
+static inline void execute_jsr(racer_mcs6507 *cpu, int operand_address) {
+	// NOTE: JSR pushes next instruction address - 1 (PC+2-1) onto
+	// stack, and there's an extra PC+1 at the end of RTS, which then
+	// correctly aligns return to the beginning of next instruction;
+	const int return_address = cpu->program_counter - 0x1;
+	push_stack(cpu, return_address >> 8);
+	push_stack(cpu, return_address & 0xff);
+	
+	cpu->program_counter = operand_address;
+}
+
+/// LDA: load accumulator.
+static inline void execute_lda(racer_mcs6507 *cpu, int operand_address) {
+	cpu->accumulator = cpu->read_bus(cpu->bus, operand_address);
+	set_result(cpu, cpu->accumulator);
+}
+
+/// LDX: load index x.
+static inline void execute_ldx(racer_mcs6507 *cpu, int operand_address) {
+	cpu->x = cpu->read_bus(cpu->bus, operand_address);
+	set_result(cpu, cpu->x);
+}
+
+/// LDY: load index y.
+static inline void execute_ldy(racer_mcs6507 *cpu, int operand_address) {
+	cpu->y = cpu->read_bus(cpu->bus, operand_address);
+	set_result(cpu, cpu->y);
+}
+
+/// LSR: shift accumulator right.
+static inline void execute_lsr_accumulator(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	const bool carry = cpu->accumulator & 0x1;
+	cpu->accumulator >>= 1;
+	
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, carry);
+	set_result(cpu, cpu->accumulator);
+}
+
+/// LSR: shift memory right.
+static inline void execute_lsr(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = operand >> 1;
+	
+	cpu->write_bus(cpu->bus, operand_address, result);
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, operand & 0x1);
+	set_result(cpu, result);
+}
+
+/// NOP: no operation.
+static inline void execute_nop(racer_mcs6507 *cpu, int operand_address) {
+	// does nothing
+	(void)cpu;
+	(void)operand_address;
+}
+
+/// ORA: OR memory with accumulator.
+static inline void execute_ora(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	cpu->accumulator |= operand;
+	
+	set_result(cpu, cpu->accumulator);
+}
+
+/// PHA: push accumulator on stack.
+static inline void execute_pha(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	push_stack(cpu, cpu->accumulator);
+}
+
+/// PHP: push status on stack.
+static inline void execute_php(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	int status = get_status(cpu);
+	add_flag(status, MCS6507_STATUS_BREAK);
+	add_flag(status, MCS6507_STATUS_UNUSED);
+	
+	push_stack(cpu, status);
+}
+
+/// PLA: pull accumulator from stack.
+static inline void execute_pla(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->accumulator = pull_stack(cpu);
+	set_result(cpu, cpu->accumulator);
+}
+
+/// PLP: pull status from stack.
+static inline void execute_plp(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	const int ignored_flags = (MCS6507_STATUS_BREAK | MCS6507_STATUS_UNUSED);
+	const int status = pull_stack(cpu);
+	
+	// preserve break and unused flags in status register
+	set_status(cpu, (status & ~ignored_flags) | (cpu->status & ignored_flags));
+}
+
+/// ROL: rotate accumulator left.
+static inline void execute_rol_accumulator(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	const bool carry = cpu->accumulator & 0x80;
+	
+	cpu->accumulator = ((cpu->accumulator << 1) | is_flag_set(cpu->status, MCS6507_STATUS_CARRY)) & 0xff;
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, carry);
+	set_result(cpu, cpu->accumulator);
+}
+
+/// ROL: rotate memory left.
+static inline void execute_rol(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = ((operand << 1) | is_flag_set(cpu->status, MCS6507_STATUS_CARRY)) & 0xff;
+	
+	cpu->write_bus(cpu->bus, operand_address, result);
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, operand & 0x80);
+	set_result(cpu, result);
+}
+
+/// ROR: rotate accumulator right.
+static inline void execute_ror_accumulator(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	const bool carry = cpu->accumulator & 0x1;
+	cpu->accumulator = (cpu->accumulator >> 1) | (is_flag_set(cpu->status, MCS6507_STATUS_CARRY) << 7);
+	
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, carry);
+	set_result(cpu, cpu->accumulator);
+}
+
+/// ROR: rotate memory right.
+static inline void execute_ror(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const int result = (operand >> 1) | (is_flag_set(cpu->status, MCS6507_STATUS_CARRY) << 7);
+	
+	cpu->write_bus(cpu->bus, operand_address, result);
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, operand & 0x1);
+	set_result(cpu, result);
+}
+
+/// RTI: return from interrupt.
+static inline void execute_rti(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	const int ignored_flags = (MCS6507_STATUS_BREAK | MCS6507_STATUS_UNUSED);
+	const int status = pull_stack(cpu);
+	
+	// preserve break and unused status flags
+	set_status(cpu, (status & ~ignored_flags) | (cpu->status & ignored_flags));
+	
+	// pull program counter from stack
+	const int low = pull_stack(cpu);
+	const int high = pull_stack(cpu);
+	cpu->program_counter = address(high, low);
+}
+
+/// RTS: return from subroutine.
+static inline void execute_rts(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	const int low = pull_stack(cpu);
+	const int high = pull_stack(cpu);
+	cpu->program_counter = address(high, low) + 0x1;
+}
+
+/// SBC: subtract memory from accumulator with borrow.
+static inline void execute_sbc(racer_mcs6507 *cpu, int operand_address) {
+	const int operand = cpu->read_bus(cpu->bus, operand_address);
+	const bool borrow = !is_flag_set(cpu->status, MCS6507_STATUS_CARRY);
+	
+	int result = cpu->accumulator - operand - borrow;
+	const int overflow = (cpu->accumulator ^ operand) & (cpu->accumulator ^ result);
+	
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, result >= 0x0);
+	set_flag(cpu->status, MCS6507_STATUS_OVERFLOW, overflow & 0x80);
+	set_result(cpu, result);
+	
+	if (is_flag_set(cpu->status, MCS6507_STATUS_DECIMAL_MODE)) {
+		// (accumulator % 0x10) - (operand % 0x10)
+		int low = (cpu->accumulator & 0x0f) - (operand & 0x0f) - borrow;
+		// (accumulator / 0x10) - (operand / 0x10)
+		int high = (cpu->accumulator >> 4) - (operand >> 4);
+		
+		if (low < 0x0) {
+			low += 0xa;
+			high -= 0x1;
+		}
+		if (high < 0x0) {
+			high += 0xa;
+			clear_flag(cpu->status, MCS6507_STATUS_CARRY);
+		} else {
+			add_flag(cpu->status, MCS6507_STATUS_CARRY);
+		}
+		
+		// high * 0x10 + low
+		result = (high << 4) | (low & 0x0f);
+	}
+	
+	cpu->accumulator = result & 0xff;
+}
+
+/// SEC: set carry flag.
+static inline void execute_sec(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	set_flag(cpu->status, MCS6507_STATUS_CARRY, true);
+}
+
+/// SED: set decimal mode.
+static inline void execute_sed(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	set_flag(cpu->status, MCS6507_STATUS_DECIMAL_MODE, true);
+}
+
+/// SEI: set interrupt disable flag.
+static inline void execute_sei(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	set_flag(cpu->status, MCS6507_STATUS_INTERRUPT_DISABLE, true);
+}
+
+/// STA: store accumulator.
+static inline void execute_sta(racer_mcs6507 *cpu, int operand_address) {
+	cpu->write_bus(cpu->bus, operand_address, cpu->accumulator);
+}
+
+/// STX: store index x.
+static inline void execute_stx(racer_mcs6507 *cpu, int operand_address) {
+	cpu->write_bus(cpu->bus, operand_address, cpu->x);
+}
+
+/// STY: store index y.
+static inline void execute_sty(racer_mcs6507 *cpu, int operand_address) {
+	cpu->write_bus(cpu->bus, operand_address, cpu->y);
+}
+
+/// TAX: transfer accumulator to index x.
+static inline void execute_tax(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->x = cpu->accumulator;
+	set_result(cpu, cpu->x);
+}
+
+/// TAY: transfer accumulator to index y.
+static inline void execute_tay(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->y = cpu->accumulator;
+	set_result(cpu, cpu->y);
+}
+
+/// TSX: transfer stack pointer to index x.
+static inline void execute_tsx(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->x = cpu->stack_pointer;
+	set_result(cpu, cpu->x);
+}
+
+/// TXA: transfer index x to accumulator.
+static inline void execute_txa(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->accumulator = cpu->x;
+	set_result(cpu, cpu->accumulator);
+}
+
+/// TXS: transfer index x to stack pointer.
+static inline void execute_txs(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->stack_pointer = cpu->x;
+}
+
+/// TYA: transfer index y to accumulator.
+static inline void execute_tya(racer_mcs6507 *cpu, int operand_address) {
+	(void)operand_address;
+	cpu->accumulator = cpu->y;
+	set_result(cpu, cpu->accumulator);
+}
+
+#endif /* mcs6507_operations_h */
@@ -11,6 +11,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 
 void racer_mcs6532_reset(racer_mcs6532 *riot) {
 	// randomize memory
@@ -36,6 +37,15 @@ void racer_mcs6532_reset(racer_mcs6532 *riot) {
 	riot->timer <<= riot->timer_scale;
 }
 
+static void expire_timer(racer_mcs6532 *riot) {
+	// set timer interrupt flag once timer expires
+	add_flag(riot->interrupt, MCS6532_TIMER_INTERRUPT);
+	// call interrupt if enabled in interrupt control
+	if (is_flag_set(riot->interrupt_control, MCS6532_TIMER_INTERRUPT)) {
+		// TODO: call interrupt
+	}
+}
+
 void racer_mcs6532_advance_clock(racer_mcs6532 *riot) {
 	// stop timer when it reaches max count down -0xff
 	if (riot->timer == -0xff) {
@@ -45,12 +55,21 @@ void racer_mcs6532_advance_clock(racer_mcs6532 *riot) {
 	riot->timer -= 1;
 	
 	if (riot->timer == -1) {
-		// set timer interrupt flag once timer expires
-		add_flag(riot->interrupt, MCS6532_TIMER_INTERRUPT);
-		// call interrupt if enabled in interrupt control
-		if (is_flag_set(riot->interrupt_control, MCS6532_TIMER_INTERRUPT)) {
-			// TODO: call interrupt
-		}
+		expire_timer(riot);
+	}
+}
+
+void racer_mcs6532_advance_clocks(racer_mcs6532 *riot, int cycles) {
+	// stop timer when it reaches max count down -0xff
+	if (riot->timer == -0xff || cycles <= 0) {
+		return;
+	}
+	
+	const int timer = riot->timer;
+	riot->timer = (cycles < timer + 0xff) ? timer - cycles : -0xff;
+	
+	if (timer >= 0 && riot->timer <= -1) {
+		expire_timer(riot);
 	}
 }
 
@@ -140,13 +159,47 @@ int racer_mcs6532_read(racer_mcs6532 *riot, int address) {
 			clear_flag(riot->interrupt, MCS6532_EDGE_DETECT_INTERRUPT);
 			return interrupt;
 		}
-			
+		
 		default:
 			printf("msc6532: invalid read address: %d.\n", address);
 			return 0;
 	}
 }
 
+int racer_mcs6532_get_steady_cycles(const racer_mcs6532 *riot, int address) {
+	switch (address & 0x7) {
+			// MARK: timer
+		case 0x4:
+			// timer stops counting down at max count down -0xff
+			if (riot->timer == -0xff) {
+				return INT_MAX;
+			}
+			
+			// timer reads the same data until it counts down past a multiple
+			// of its interval; once expired, it reads different data on every
+			// cycle
+			return riot->timer >= 0
+			? riot->timer & ((1 << riot->timer_scale) - 1)
+			: 0;
+			
+			// MARK: interrupt flag
+		case 0x5:
+			// reading interrupt flag clears edge detect interrupt flag, so
+			// the following read differs while it is set
+			if (is_flag_set(riot->interrupt, MCS6532_EDGE_DETECT_INTERRUPT)) {
+				return 0;
+			}
+			
+			// timer interrupt flag is only set once timer expires
+			return riot->timer >= 0
+			? riot->timer
+			: INT_MAX;
+		
+		default:
+			return 0;
+	}
+}
+
 void racer_mcs6532_write(racer_mcs6532 *riot, int address, int data) {
 	switch (address & 0x1f) {
 			// MARK: data a
@@ -196,7 +249,7 @@ void racer_mcs6532_write(racer_mcs6532 *riot, int address, int data) {
 			riot->write_port[1](riot->peripherals[1], port_data);
 			break;
 		}
-			
+		
 		case 0x4: case 0x5: case 0x6: case 0x7:
 			// MARK: edge detect
 			set_flag(riot->interrupt_control, MCS6532_EDGE_DETECT_POLARITY, address & 0x1);
@@ -238,7 +291,7 @@ void racer_mcs6532_write(racer_mcs6532 *riot, int address, int data) {
 			riot->timer_scale = 10;
 			riot->timer = data << riot->timer_scale;
 			break;
-			
+		
 		default:
 			printf("msc6532: invalid write address: %d.\n", address);
 			break;
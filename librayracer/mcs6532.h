@@ -64,6 +64,13 @@ void racer_mcs6532_reset(racer_mcs6532 *riot);
  */
 void racer_mcs6532_advance_clock(racer_mcs6532 *riot);
 
+/**
+ * Advances internal clock of the MCS6532 by the specified number of cycles.
+ *
+ * This function is equivalent to advancing the clock by 1 cycle the specified number of times.
+ */
+void racer_mcs6532_advance_clocks(racer_mcs6532 *riot, int cycles);
+
 /**
  * Reads data from the MCS6532 (excluding RAM).
  *
@@ -72,6 +79,17 @@ void racer_mcs6532_advance_clock(racer_mcs6532 *riot);
  */
 int racer_mcs6532_read(racer_mcs6532 *riot, int address);
 
+/**
+ * Returns the number of cycles, for which reading the specified address from the MCS6532 keeps
+ * returning the same data with the same effect as reading it on the current cycle; `INT_MAX` when it
+ * always does.
+ *
+ * Only timer and interrupt flag addresses may return non-zero number of cycles; data read from any
+ * other address may change on any cycle. Reading the interrupt flag clears edge detect interrupt
+ * flag, so it returns 0 while that flag is set; it must be called before reading the address.
+ */
+int racer_mcs6532_get_steady_cycles(const racer_mcs6532 *riot, int address);
+
 /**
  * Writes data to the MCS6532 (excluding RAM).
  *
@@ -0,0 +1,173 @@
+//
+//  observation.c
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#include "observation.h"
+#include "video.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct racer_observation {
+	racer_observation_config config;
+	
+	/// The first color clock of every pixel column, and the end of the last one, with average
+	/// filter; the color clock at the center of every pixel column, with decimation filter.
+	int columns[160 + 1];
+	
+	/// Pixel row, which every scan line reduces into, or -1 when it is skipped by decimation
+	/// filter; and the number of scan lines, which reduce into every pixel row.
+	int *line_rows;
+	int *row_line_counts;
+	
+	/// Sums of color clock lumas of the pixel row, which is currently being averaged, one for every
+	/// pixel column, and the number of scan lines summed into them.
+	uint32_t *sums;
+	int sum_row;
+	int sum_line_count;
+	
+	/// Pixels of the current field, of the last completed field, and the output ones.
+	uint8_t *field;
+	uint8_t *last_field;
+	uint8_t *pixels;
+};
+
+
+// MARK: -
+racer_observation *racer_observation_create(const racer_observation_config *config) {
+	racer_observation *observation = (racer_observation *)malloc(sizeof(racer_observation));
+	observation->config = *config;
+	
+	const int width = config->width;
+	const int height = config->height;
+	const int line_count = config->line_count;
+	const bool is_decimated = config->filter == OBSERVATION_FILTER_DECIMATE;
+	
+	// pixel columns and rows split color clocks and scan lines evenly,
+	// with decimation sampling the middle of each one
+	for (int column = 0; column <= width; ++column) {
+		observation->columns[column] = is_decimated
+		? (2 * column + 1) * 160 / (2 * width)
+		: column * 160 / width;
+	}
+	
+	observation->line_rows = (int *)malloc(sizeof(int) * line_count);
+	observation->row_line_counts = (int *)malloc(sizeof(int) * height);
+	for (int row = 0; row < height; ++row) {
+		const int first_line = row * line_count / height;
+		const int end_line = (row + 1) * line_count / height;
+		for (int line = first_line; line < end_line; ++line) {
+			observation->line_rows[line] = is_decimated ? -1 : row;
+		}
+		observation->row_line_counts[row] = is_decimated ? 1 : end_line - first_line;
+	}
+	
+	// middle scan line of a pixel row may fall into the next one, when
+	// rows do not split scan lines evenly
+	for (int row = 0; row < height && is_decimated; ++row) {
+		observation->line_rows[(2 * row + 1) * line_count / (2 * height)] = row;
+	}
+	
+	observation->sums = (uint32_t *)calloc(width, sizeof(uint32_t));
+	observation->sum_row = -1;
+	observation->sum_line_count = 0;
+	
+	observation->field = (uint8_t *)calloc(width * height, sizeof(uint8_t));
+	observation->last_field = (uint8_t *)calloc(width * height, sizeof(uint8_t));
+	observation->pixels = (uint8_t *)calloc(width * height, sizeof(uint8_t));
+	return observation;
+}
+
+void racer_observation_destroy(racer_observation *observation) {
+	free(observation->line_rows);
+	free(observation->row_line_counts);
+	free(observation->sums);
+	free(observation->field);
+	free(observation->last_field);
+	free(observation->pixels);
+	free(observation);
+}
+
+
+// MARK: -
+// MARK: Reduction
+
+/// Stores the average of summed lumas into the pixel row, which is currently being averaged.
+static void store_sums(racer_observation *observation) {
+	const int width = observation->config.width;
+	uint8_t *pixels = observation->field + observation->sum_row * width;
+	
+	for (int column = 0; column < width; ++column) {
+		const int count = observation->sum_line_count * (observation->columns[column + 1] - observation->columns[column]);
+		pixels[column] = (observation->sums[column] + count / 2) / count;
+	}
+}
+
+void racer_observation_add_line(racer_observation *observation, int index, const uint8_t *colors) {
+	const int row = observation->line_rows[index];
+	if (row < 0) {
+		return;
+	}
+	
+	uint8_t lumas[160];
+	racer_video_convert(colors, 160, 1, NULL, VIDEO_FORMAT_GRAY8, lumas, sizeof(lumas));
+	
+	const int width = observation->config.width;
+	if (observation->config.filter == OBSERVATION_FILTER_DECIMATE) {
+		uint8_t *pixels = observation->field + row * width;
+		for (int column = 0; column < width; ++column) {
+			pixels[column] = lumas[observation->columns[column]];
+		}
+		return;
+	}
+	
+	// start summing the next pixel row, discarding the previous one when
+	// any of its scan lines were missing
+	if (row != observation->sum_row) {
+		memset(observation->sums, 0, sizeof(uint32_t) * width);
+		observation->sum_row = row;
+		observation->sum_line_count = 0;
+	}
+	
+	for (int column = 0; column < width; ++column) {
+		uint32_t sum = 0;
+		for (int clock = observation->columns[column]; clock < observation->columns[column + 1]; ++clock) {
+			sum += lumas[clock];
+		}
+		observation->sums[column] += sum;
+	}
+	
+	observation->sum_line_count += 1;
+	if (observation->sum_line_count == observation->row_line_counts[row]) {
+		store_sums(observation);
+		observation->sum_row = -1;
+	}
+}
+
+void racer_observation_complete_field(racer_observation *observation) {
+	const int size = observation->config.width * observation->config.height;
+	if (observation->config.is_max_pooled) {
+		for (int index = 0; index < size; ++index) {
+			const uint8_t pixel = observation->field[index];
+			const uint8_t last_pixel = observation->last_field[index];
+			observation->pixels[index] = (pixel > last_pixel) ? pixel : last_pixel;
+		}
+	} else {
+		memcpy(observation->pixels, observation->field, size);
+	}
+	
+	// the current field becomes the last one, and the next one starts
+	// out black
+	uint8_t *last_field = observation->last_field;
+	observation->last_field = observation->field;
+	observation->field = last_field;
+	memset(observation->field, 0, size);
+	observation->sum_row = -1;
+}
+
+const uint8_t *racer_observation_get_pixels(const racer_observation *observation) {
+	return observation->pixels;
+}
@@ -0,0 +1,64 @@
+//
+//  observation.h
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#ifndef observation_h
+#define observation_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/// Filters, which reduce visible color clocks of a field into pixels of an observation.
+typedef enum {
+	/// Each pixel takes the color clock nearest to its center.
+	OBSERVATION_FILTER_DECIMATE,
+	
+	/// Each pixel takes the mean of all color clocks it covers.
+	OBSERVATION_FILTER_AVERAGE
+} racer_observation_filter;
+
+/// Configuration of an observation.
+typedef struct {
+	/// Size of observation in pixels, at most 160 by the number of scan lines.
+	int width;
+	int height;
+	
+	/// The number of scan lines, which are reduced into observation; must be the same as the number
+	/// of scan lines in vertical window of visible TIA layout.
+	int line_count;
+	
+	racer_observation_filter filter;
+	
+	/// Whether every pixel takes the maximum of its values in the last two fields, rather than its
+	/// value in the last one.
+	bool is_max_pooled;
+} racer_observation_config;
+
+/// Grayscale observation, which scan lines of a field in visible TIA layout reduce into, one at
+/// a time, as soon as they are drawn; fields are never stored at full resolution.
+typedef struct racer_observation racer_observation;
+
+/// Creates observation with the specified configuration; all of its pixels are initially black.
+racer_observation *racer_observation_create(const racer_observation_config *config);
+
+/// Destroys the specified observation.
+void racer_observation_destroy(racer_observation *observation);
+
+/// Reduces the specified 160 visible TIA color values of a scan line, at the specified index within
+/// vertical window, into the current field of observation.
+///
+/// Scan lines must be added in order; any of them may be missing, in which case pixels they would
+/// have reduced into stay black.
+void racer_observation_add_line(racer_observation *observation, int index, const uint8_t *colors);
+
+/// Completes the current field of observation, which updates its pixels, and starts the next one.
+void racer_observation_complete_field(racer_observation *observation);
+
+/// Returns grayscale pixels of observation as of the last completed field, row by row, without any
+/// padding.
+const uint8_t *racer_observation_get_pixels(const racer_observation *observation);
+
+#endif /* observation_h */
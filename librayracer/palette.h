@@ -0,0 +1,51 @@
+//
+//  palette.h
+//  librayracer
+//
+//  Created by Serge Tsyba on 16.10.2026.
+//
+
+#ifndef palette_h
+#define palette_h
+
+/// NTSC palette, a color for each of 128 TIA color values (i.e. the 7 most significant bits of color
+/// registers), 8 luminances of every hue.
+///
+/// Colors are listed as invocations of the specified macro with red, green and blue components (0-255)
+/// of every color, so that both video conversion and the screen shader expand the same palette, each
+/// into its own format; the macro itself compiles as C and Metal alike.
+#define NTSC_PALETTE(COLOR) \
+	COLOR(0x00, 0x00, 0x00) COLOR(0x40, 0x40, 0x40) COLOR(0x6c, 0x6c, 0x6c) COLOR(0x90, 0x90, 0x90) \
+	COLOR(0xb0, 0xb0, 0xb0) COLOR(0xc8, 0xc8, 0xc8) COLOR(0xdc, 0xdc, 0xdc) COLOR(0xec, 0xec, 0xec) \
+	COLOR(0x44, 0x44, 0x00) COLOR(0x64, 0x64, 0x10) COLOR(0x84, 0x84, 0x24) COLOR(0xa0, 0xa0, 0x34) \
+	COLOR(0xb8, 0xb8, 0x40) COLOR(0xd0, 0xd0, 0x50) COLOR(0xe8, 0xe8, 0x5c) COLOR(0xfc, 0xfc, 0x68) \
+	COLOR(0x70, 0x28, 0x00) COLOR(0x84, 0x44, 0x14) COLOR(0x98, 0x5c, 0x28) COLOR(0xac, 0x78, 0x3c) \
+	COLOR(0xbc, 0x8c, 0x4c) COLOR(0xcc, 0xa0, 0x5c) COLOR(0xdc, 0xb4, 0x68) COLOR(0xec, 0xc8, 0x78) \
+	COLOR(0x84, 0x18, 0x00) COLOR(0x98, 0x34, 0x18) COLOR(0xac, 0x50, 0x30) COLOR(0xc0, 0x68, 0x48) \
+	COLOR(0xd0, 0x80, 0x5c) COLOR(0xe0, 0x94, 0x70) COLOR(0xec, 0xa8, 0x80) COLOR(0xfc, 0xbc, 0x94) \
+	COLOR(0x88, 0x00, 0x00) COLOR(0x9c, 0x20, 0x20) COLOR(0xb0, 0x3c, 0x3c) COLOR(0xc0, 0x58, 0x58) \
+	COLOR(0xd0, 0x70, 0x70) COLOR(0xe0, 0x88, 0x88) COLOR(0xec, 0xa0, 0xa0) COLOR(0xfc, 0xb4, 0xb4) \
+	COLOR(0x78, 0x00, 0x5c) COLOR(0x8c, 0x20, 0x74) COLOR(0xa0, 0x3c, 0x88) COLOR(0xb0, 0x58, 0x9c) \
+	COLOR(0xc0, 0x70, 0xb0) COLOR(0xd0, 0x84, 0xc0) COLOR(0xdc, 0x9c, 0xd0) COLOR(0xec, 0xb0, 0xe0) \
+	COLOR(0x48, 0x00, 0x78) COLOR(0x60, 0x20, 0x90) COLOR(0x78, 0x3c, 0xa4) COLOR(0x8c, 0x58, 0xb8) \
+	COLOR(0xa0, 0x70, 0xcc) COLOR(0xb4, 0x84, 0xdc) COLOR(0xc4, 0x9c, 0xec) COLOR(0xd4, 0xb0, 0xfc) \
+	COLOR(0x14, 0x00, 0x84) COLOR(0x30, 0x20, 0x98) COLOR(0x4c, 0x3c, 0xac) COLOR(0x68, 0x58, 0xc0) \
+	COLOR(0x7c, 0x70, 0xd0) COLOR(0x94, 0x88, 0xe0) COLOR(0xa8, 0xa0, 0xec) COLOR(0xbc, 0xb4, 0xfc) \
+	COLOR(0x00, 0x00, 0x88) COLOR(0x1c, 0x20, 0x9c) COLOR(0x38, 0x40, 0xb0) COLOR(0x50, 0x5c, 0xc0) \
+	COLOR(0x68, 0x74, 0xd0) COLOR(0x7c, 0x8c, 0xe0) COLOR(0x90, 0xa4, 0xec) COLOR(0xa4, 0xb8, 0xfc) \
+	COLOR(0x00, 0x18, 0x7c) COLOR(0x1c, 0x38, 0x90) COLOR(0x38, 0x54, 0xa8) COLOR(0x50, 0x70, 0xbc) \
+	COLOR(0x68, 0x88, 0xcc) COLOR(0x7c, 0x9c, 0xdc) COLOR(0x90, 0xb4, 0xec) COLOR(0xa4, 0xc8, 0xfc) \
+	COLOR(0x00, 0x2c, 0x5c) COLOR(0x1c, 0x4c, 0x78) COLOR(0x38, 0x68, 0x90) COLOR(0x50, 0x84, 0xac) \
+	COLOR(0x68, 0x9c, 0xc0) COLOR(0x7c, 0xb4, 0xd4) COLOR(0x90, 0xcc, 0xe8) COLOR(0xa4, 0xe0, 0xfc) \
+	COLOR(0x00, 0x3c, 0x2c) COLOR(0x1c, 0x5c, 0x48) COLOR(0x38, 0x7c, 0x64) COLOR(0x50, 0x9c, 0x80) \
+	COLOR(0x68, 0xb4, 0x94) COLOR(0x7c, 0xd0, 0xac) COLOR(0x90, 0xe4, 0xc0) COLOR(0xa4, 0xfc, 0xd4) \
+	COLOR(0x00, 0x3c, 0x00) COLOR(0x20, 0x5c, 0x20) COLOR(0x40, 0x7c, 0x40) COLOR(0x5c, 0x9c, 0x5c) \
+	COLOR(0x74, 0xb4, 0x74) COLOR(0x8c, 0xd0, 0x8c) COLOR(0xa4, 0xe4, 0xa4) COLOR(0xb8, 0xfc, 0xb8) \
+	COLOR(0x14, 0x38, 0x00) COLOR(0x34, 0x5c, 0x1c) COLOR(0x50, 0x7c, 0x38) COLOR(0x6c, 0x98, 0x50) \
+	COLOR(0x84, 0xb4, 0x68) COLOR(0x9c, 0xcc, 0x7c) COLOR(0xb4, 0xe4, 0x90) COLOR(0xc8, 0xfc, 0xa4) \
+	COLOR(0x2c, 0x30, 0x00) COLOR(0x4c, 0x50, 0x1c) COLOR(0x68, 0x70, 0x34) COLOR(0x84, 0x8c, 0x4c) \
+	COLOR(0x9c, 0xa8, 0x64) COLOR(0xb4, 0xc0, 0x78) COLOR(0xcc, 0xd4, 0x88) COLOR(0xe0, 0xec, 0x9c) \
+	COLOR(0x44, 0x28, 0x00) COLOR(0x64, 0x48, 0x18) COLOR(0x84, 0x68, 0x30) COLOR(0xa0, 0x84, 0x44) \
+	COLOR(0xb8, 0x9c, 0x58) COLOR(0xd0, 0xb4, 0x6c) COLOR(0xe8, 0xcc, 0x7c) COLOR(0xfc, 0xe0, 0x8c)
+
+#endif /* palette_h */
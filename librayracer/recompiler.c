@@ -0,0 +1,1007 @@
+//
+//  recompiler.c
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#include "recompiler.h"
+#include "mcs6507_operations.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+#if defined(__x86_64__)
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(MAP_JIT)
+#include <pthread.h>
+#endif
+#endif
+
+/// The number of times a basic block runs before it is compiled.
+#define HOT_BLOCK_THRESHOLD 8
+
+/// The maximum number of bus accesses a basic block can make: every operation can make at most
+/// 3 stack accesses, 2 accesses resolving its next operation and a decode lookup.
+#define MAX_BLOCK_EVENTS (UINT8_MAX * 8)
+
+typedef struct {
+	const predecoded *operation;
+	racer_mcs6507_handlers handlers;
+} compiled_operation;
+
+/// Native code of a compiled block; runs the same as `run_compiled_block`.
+typedef int (*native_block)(racer_atari2600 *console, racer_recompiler *recompiler, int cycles);
+
+typedef struct {
+	int bank_index;
+	int length;
+	
+	// whether compiled and interpreted block differ in differential mode,
+	// in which case the block is left to the interpreter
+	bool is_different;
+	
+	native_block native;
+	compiled_operation operations[];
+} compiled_block;
+
+typedef enum {
+	EVENT_READ,
+	EVENT_WRITE,
+	EVENT_DECODE
+} event_type;
+
+/// A bus access recorded in differential mode.
+typedef struct {
+	event_type type;
+	int address;
+	int data;
+} event;
+
+struct racer_recompiler {
+	const racer_cartridge_program *program;
+	const int *bank_index;
+	
+	compiled_block **blocks;
+	uint8_t *heat;
+	
+	// whether translated and interpreted block, which starts at each
+	// program offset, differ in differential mode
+	bool *is_translated_different;
+	
+	// bus accesses recorded in differential mode, and the index of the next
+	// one to replay
+	event events[MAX_BLOCK_EVENTS];
+	int event_count;
+	int event_index;
+	bool is_recording;
+	
+	// whether the block being verified in differential mode is translated,
+	// the bank it started in, and whether it differs, and the first
+	// difference found in any block
+	bool is_translated;
+	int recorded_bank_index;
+	bool is_different;
+	const char *difference;
+	
+	// executable memory, which native code of compiled blocks is emitted to
+	uint8_t *native_code;
+	size_t native_code_size;
+	size_t native_code_count;
+};
+
+
+// MARK: -
+// MARK: Program code
+
+/// Returns cartridge program offset of the specified bus address in the specified bank.
+static int get_program_offset(const racer_recompiler *recompiler, int address, int bank_index) {
+	if (recompiler->program->type == CARTRIDGE_ATARI_2KB) {
+		return address & 0x7ff;
+	} else {
+		return bank_index * 0x1000 + (address & 0xfff);
+	}
+}
+
+/// Records lookup of the next operation of a compiled block, when differential mode is recording.
+static void record_next_decode(racer_recompiler *recompiler, const racer_mcs6507 *mpu) {
+	if (recompiler->is_recording) {
+		const int offset = get_program_offset(recompiler, mpu->program_counter, *recompiler->bank_index);
+		racer_recompiler_record_decode(recompiler, mpu->program_counter, offset);
+	}
+}
+
+
+// MARK: -
+// MARK: Native code
+
+#if defined(__x86_64__)
+
+/// The size of executable memory, which native code of compiled blocks is emitted to; blocks, which
+/// do not fit, run as threaded code.
+#define NATIVE_CODE_SIZE (4 << 20)
+
+/// The maximum size of native code of a single compiled operation, and of block entry and exit.
+#define MAX_NATIVE_OPERATION_SIZE 320
+
+/// x86-64 registers used by native code.
+typedef enum {
+	REGISTER_RAX = 0,
+	REGISTER_RCX = 1,
+	REGISTER_RDX = 2,
+	REGISTER_RSI = 6,
+	REGISTER_RDI = 7,
+	
+	// console, MPU, recompiler, cycles and cycle count are kept in callee
+	// saved registers
+	REGISTER_CONSOLE = 3,
+	REGISTER_MPU = 12,
+	REGISTER_RECOMPILER = 13,
+	REGISTER_CYCLES = 14,
+	REGISTER_COUNT = 15
+} native_register;
+
+/// Native code being emitted.
+typedef struct {
+	uint8_t *bytes;
+	int size;
+} native_emitter;
+
+static void emit_byte(native_emitter *emitter, int byte) {
+	emitter->bytes[emitter->size++] = (uint8_t)byte;
+}
+
+static void emit_int32(native_emitter *emitter, int32_t value) {
+	memcpy(&emitter->bytes[emitter->size], &value, sizeof(value));
+	emitter->size += sizeof(value);
+}
+
+static void emit_int64(native_emitter *emitter, uint64_t value) {
+	memcpy(&emitter->bytes[emitter->size], &value, sizeof(value));
+	emitter->size += sizeof(value);
+}
+
+/// Emits operation with the specified opcode, 32-bit (or 64-bit when wide) register and register
+/// operands.
+static void emit_register_operation(native_emitter *emitter, bool is_wide, int opcode, native_register reg, native_register rm) {
+	const int rex = (is_wide ? 0x48 : 0x40) | ((reg & 0x8) ? 0x4 : 0) | ((rm & 0x8) ? 0x1 : 0);
+	if (rex != 0x40) {
+		emit_byte(emitter, rex);
+	}
+	emit_byte(emitter, opcode);
+	emit_byte(emitter, 0xc0 | ((reg & 0x7) << 3) | (rm & 0x7));
+}
+
+/// Emits operation with the specified opcode, 32-bit (or 64-bit when wide) register (or opcode
+/// extension) and memory operand at the specified offset from the specified base register.
+static void emit_memory_operation(native_emitter *emitter, bool is_wide, int opcode, int reg, native_register base, size_t offset) {
+	const int rex = (is_wide ? 0x48 : 0x40) | ((reg & 0x8) ? 0x4 : 0) | ((base & 0x8) ? 0x1 : 0);
+	if (rex != 0x40) {
+		emit_byte(emitter, rex);
+	}
+	emit_byte(emitter, opcode);
+	emit_byte(emitter, 0x80 | ((reg & 0x7) << 3) | (base & 0x7));
+	
+	// base register r12 can only be addressed with SIB byte
+	if ((base & 0x7) == 0x4) {
+		emit_byte(emitter, 0x24);
+	}
+	emit_int32(emitter, (int32_t)offset);
+}
+
+/// Emits `push reg`.
+static void emit_push(native_emitter *emitter, native_register reg) {
+	if (reg & 0x8) {
+		emit_byte(emitter, 0x41);
+	}
+	emit_byte(emitter, 0x50 | (reg & 0x7));
+}
+
+/// Emits `pop reg`.
+static void emit_pop(native_emitter *emitter, native_register reg) {
+	if (reg & 0x8) {
+		emit_byte(emitter, 0x41);
+	}
+	emit_byte(emitter, 0x58 | (reg & 0x7));
+}
+
+/// Emits `mov reg, imm64`.
+static void emit_load_pointer(native_emitter *emitter, native_register reg, const void *pointer) {
+	emit_byte(emitter, 0x48);
+	emit_byte(emitter, 0xb8 | reg);
+	emit_int64(emitter, (uint64_t)(uintptr_t)pointer);
+}
+
+/// Emits call of the specified function with arguments already in place.
+static void emit_call(native_emitter *emitter, const void *function) {
+	// mov rax, function; call rax
+	emit_load_pointer(emitter, REGISTER_RAX, function);
+	emit_byte(emitter, 0xff);
+	emit_byte(emitter, 0xd0);
+}
+
+/// Emits `mov dword [base + offset], imm32`.
+static void emit_store_immediate(native_emitter *emitter, native_register base, size_t offset, int32_t value) {
+	emit_memory_operation(emitter, false, 0xc7, 0, base, offset);
+	emit_int32(emitter, value);
+}
+
+/// Emits conditional (or unconditional, with condition -1) jump, and returns offset of its 32-bit
+/// displacement to patch.
+static int emit_jump(native_emitter *emitter, int condition) {
+	if (condition < 0) {
+		emit_byte(emitter, 0xe9);
+	} else {
+		emit_byte(emitter, 0x0f);
+		emit_byte(emitter, 0x80 | condition);
+	}
+	
+	emit_int32(emitter, 0);
+	return emitter->size - 4;
+}
+
+/// Patches the specified jumps to continue at the current end of native code.
+static void patch_jumps(native_emitter *emitter, const int *jumps, int count) {
+	for (int index = 0; index < count; ++index) {
+		const int32_t displacement = emitter->size - (jumps[index] + 4);
+		memcpy(&emitter->bytes[jumps[index]], &displacement, sizeof(displacement));
+	}
+}
+
+/// Conditions of x86-64 conditional jumps.
+enum {
+	CONDITION_EQUAL = 0x4,
+	CONDITION_NOT_EQUAL = 0x5,
+	CONDITION_GREATER = 0xf
+};
+
+#define MPU_FIELD(field) offsetof(racer_mcs6507, field)
+#define CONSOLE_FIELD(field) offsetof(racer_atari2600, field)
+
+/// Emits code, which sets register of the specified MPU field to the value of another one, with
+/// zero and negative results set from it (unless this is stack pointer).
+static void emit_transfer(native_emitter *emitter, size_t source, size_t destination) {
+	emit_memory_operation(emitter, false, 0x8b, REGISTER_RAX, REGISTER_MPU, source);
+	emit_memory_operation(emitter, false, 0x89, REGISTER_RAX, REGISTER_MPU, destination);
+	if (destination != MPU_FIELD(stack_pointer)) {
+		emit_memory_operation(emitter, false, 0x89, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(zero_result));
+		emit_memory_operation(emitter, false, 0x89, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(negative_result));
+	}
+}
+
+/// Emits code, which adds the specified delta to the specified MPU index register, with zero and
+/// negative results set from it.
+static void emit_increment(native_emitter *emitter, size_t index, int delta) {
+	emit_memory_operation(emitter, false, 0x8b, REGISTER_RAX, REGISTER_MPU, index);
+	
+	// add eax, delta; and eax, 0xff
+	emit_byte(emitter, 0x83);
+	emit_byte(emitter, 0xc0);
+	emit_byte(emitter, delta & 0xff);
+	emit_byte(emitter, 0x25);
+	emit_int32(emitter, 0xff);
+	
+	emit_memory_operation(emitter, false, 0x89, REGISTER_RAX, REGISTER_MPU, index);
+	emit_memory_operation(emitter, false, 0x89, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(zero_result));
+	emit_memory_operation(emitter, false, 0x89, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(negative_result));
+}
+
+/// Emits code, which sets (or clears) the specified flag of MPU status.
+static void emit_set_flag(native_emitter *emitter, racer_mcs6507_status flag, bool is_set) {
+	if (is_set) {
+		emit_memory_operation(emitter, false, 0x81, 1, REGISTER_MPU, MPU_FIELD(status));
+		emit_int32(emitter, flag);
+	} else {
+		emit_memory_operation(emitter, false, 0x81, 4, REGISTER_MPU, MPU_FIELD(status));
+		emit_int32(emitter, ~flag);
+	}
+}
+
+/// Emits call of the execute handler of the specified compiled operation.
+static void emit_execute_call(native_emitter *emitter, const compiled_operation *operation) {
+	// execute(mpu, mpu->operation.address)
+	emit_register_operation(emitter, true, 0x89, REGISTER_MPU, REGISTER_RDI);
+	emit_memory_operation(emitter, false, 0x8b, REGISTER_RSI, REGISTER_MPU, MPU_FIELD(operation.address));
+	emit_call(emitter, (const void *)operation->handlers.execute);
+}
+
+/// Returns whether the specified compiled operation loads or stores an MPU register at a fixed address
+/// in RAM; additionally returns offset of such register, and whether it is stored.
+static bool is_ram_access(const compiled_operation *operation, size_t *reg, bool *is_store) {
+	const predecoded *predecoded = operation->operation;
+	if ((predecoded->addressing != ADDRESSING_0_PAGE && predecoded->addressing != ADDRESSING_ABSOLUTE)
+		|| (predecoded->operand & 0x1280) != 0x0080) {
+		return false;
+	}
+	
+	switch (operation_formats[predecoded->code].operation) {
+		case OPERATION_LDA:
+		case OPERATION_STA:
+			*reg = MPU_FIELD(accumulator);
+			break;
+		case OPERATION_LDX:
+		case OPERATION_STX:
+			*reg = MPU_FIELD(x);
+			break;
+		case OPERATION_LDY:
+		case OPERATION_STY:
+			*reg = MPU_FIELD(y);
+			break;
+		default:
+			return false;
+	}
+	
+	const int type = operation_formats[predecoded->code].operation;
+	*is_store = type == OPERATION_STA || type == OPERATION_STX || type == OPERATION_STY;
+	return true;
+}
+
+/// Emits load or store of the specified MPU register at the fixed RAM address of the specified
+/// compiled operation.
+///
+/// RAM is accessed directly, unless differential mode is recording bus accesses, in which case the
+/// operation handler is called instead.
+static void emit_ram_access(native_emitter *emitter, const compiled_operation *operation, size_t reg, bool is_store) {
+	emit_memory_operation(emitter, false, 0x80, 7, REGISTER_RECOMPILER, offsetof(racer_recompiler, is_recording));
+	emit_byte(emitter, 0x00);
+	const int call_jump = emit_jump(emitter, CONDITION_NOT_EQUAL);
+	
+	// rax = console->riot, rcx = offset of RAM byte in it
+	const size_t offset = offsetof(racer_mcs6532, memory) + (operation->operation->operand & 0x7f);
+	emit_memory_operation(emitter, true, 0x8b, REGISTER_RAX, REGISTER_CONSOLE, CONSOLE_FIELD(riot));
+	if (is_store) {
+		// mov ecx, register; mov byte [rax + offset], cl
+		emit_memory_operation(emitter, false, 0x8b, REGISTER_RCX, REGISTER_MPU, reg);
+		emit_memory_operation(emitter, false, 0x88, REGISTER_RCX, REGISTER_RAX, offset);
+	} else {
+		// movzx ecx, byte [rax + offset]
+		emit_byte(emitter, 0x0f);
+		emit_memory_operation(emitter, false, 0xb6, REGISTER_RCX, REGISTER_RAX, offset);
+		emit_memory_operation(emitter, false, 0x89, REGISTER_RCX, REGISTER_MPU, reg);
+		emit_memory_operation(emitter, false, 0x89, REGISTER_RCX, REGISTER_MPU, MPU_FIELD(zero_result));
+		emit_memory_operation(emitter, false, 0x89, REGISTER_RCX, REGISTER_MPU, MPU_FIELD(negative_result));
+	}
+	const int done_jump = emit_jump(emitter, -1);
+	
+	patch_jumps(emitter, &call_jump, 1);
+	emit_execute_call(emitter, operation);
+	patch_jumps(emitter, &done_jump, 1);
+}
+
+/// Emits execution of the current MPU operation, which is the specified compiled operation.
+///
+/// Operations, which only move data between MPU registers or change status flags, and loads and
+/// stores at fixed RAM addresses are emitted inline; the rest call their operation handlers.
+static void emit_execute(native_emitter *emitter, const compiled_operation *operation) {
+	size_t reg;
+	bool is_store;
+	if (is_ram_access(operation, &reg, &is_store)) {
+		emit_ram_access(emitter, operation, reg, is_store);
+		return;
+	}
+	
+	switch (operation_formats[operation->operation->code].operation) {
+		case OPERATION_NOP:
+			break;
+		case OPERATION_TAX:
+			emit_transfer(emitter, MPU_FIELD(accumulator), MPU_FIELD(x));
+			break;
+		case OPERATION_TAY:
+			emit_transfer(emitter, MPU_FIELD(accumulator), MPU_FIELD(y));
+			break;
+		case OPERATION_TXA:
+			emit_transfer(emitter, MPU_FIELD(x), MPU_FIELD(accumulator));
+			break;
+		case OPERATION_TYA:
+			emit_transfer(emitter, MPU_FIELD(y), MPU_FIELD(accumulator));
+			break;
+		case OPERATION_TSX:
+			emit_transfer(emitter, MPU_FIELD(stack_pointer), MPU_FIELD(x));
+			break;
+		case OPERATION_TXS:
+			emit_transfer(emitter, MPU_FIELD(x), MPU_FIELD(stack_pointer));
+			break;
+		case OPERATION_INX:
+			emit_increment(emitter, MPU_FIELD(x), 1);
+			break;
+		case OPERATION_INY:
+			emit_increment(emitter, MPU_FIELD(y), 1);
+			break;
+		case OPERATION_DEX:
+			emit_increment(emitter, MPU_FIELD(x), -1);
+			break;
+		case OPERATION_DEY:
+			emit_increment(emitter, MPU_FIELD(y), -1);
+			break;
+		case OPERATION_CLC:
+			emit_set_flag(emitter, MCS6507_STATUS_CARRY, false);
+			break;
+		case OPERATION_SEC:
+			emit_set_flag(emitter, MCS6507_STATUS_CARRY, true);
+			break;
+		case OPERATION_CLD:
+			emit_set_flag(emitter, MCS6507_STATUS_DECIMAL_MODE, false);
+			break;
+		case OPERATION_SED:
+			emit_set_flag(emitter, MCS6507_STATUS_DECIMAL_MODE, true);
+			break;
+		case OPERATION_CLI:
+			emit_set_flag(emitter, MCS6507_STATUS_INTERRUPT_DISABLE, false);
+			break;
+		case OPERATION_SEI:
+			emit_set_flag(emitter, MCS6507_STATUS_INTERRUPT_DISABLE, true);
+			break;
+		case OPERATION_CLV:
+			emit_set_flag(emitter, MCS6507_STATUS_OVERFLOW, false);
+			break;
+		default:
+			emit_execute_call(emitter, operation);
+			break;
+	}
+}
+
+/// Emits resolution of the specified compiled operation as the next MPU operation.
+///
+/// Operations, which address no memory, immediate operands or fixed memory addresses, resolve to
+/// constants and are emitted inline; the rest call their resolve handlers.
+static void emit_resolve(native_emitter *emitter, const compiled_operation *operation) {
+	const predecoded *next = operation->operation;
+	switch (next->addressing) {
+		case ADDRESSING_IMPLIED:
+			emit_store_immediate(emitter, REGISTER_MPU, MPU_FIELD(operation.address), -1);
+			break;
+		case ADDRESSING_IMMEDIATE:
+			// address = program_counter + 1
+			emit_memory_operation(emitter, false, 0x8b, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(program_counter));
+			emit_byte(emitter, 0x83);
+			emit_byte(emitter, 0xc0);
+			emit_byte(emitter, 0x01);
+			emit_memory_operation(emitter, false, 0x89, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(operation.address));
+			break;
+		case ADDRESSING_0_PAGE:
+		case ADDRESSING_ABSOLUTE:
+			emit_store_immediate(emitter, REGISTER_MPU, MPU_FIELD(operation.address), next->operand);
+			break;
+		default:
+			// resolve(mpu, next)
+			emit_register_operation(emitter, true, 0x89, REGISTER_MPU, REGISTER_RDI);
+			emit_load_pointer(emitter, REGISTER_RSI, next);
+			emit_call(emitter, (const void *)operation->handlers.resolve);
+			return;
+	}
+	
+	emit_store_immediate(emitter, REGISTER_MPU, MPU_FIELD(operation.code), next->code);
+	emit_store_immediate(emitter, REGISTER_MPU, MPU_FIELD(operation.duration), next->duration);
+	emit_store_immediate(emitter, REGISTER_MPU, MPU_FIELD(operation.length), next->length);
+}
+
+/// Emits native code of the specified compiled block into the specified buffer, which must fit
+/// `MAX_NATIVE_OPERATION_SIZE` bytes per operation and 2 more; returns the size of emitted code.
+///
+/// Emitted code runs the same as `run_compiled_block`, except that operations are executed and
+/// resolved without looping over or calling through compiled operations.
+static int emit_native_block(const racer_recompiler *recompiler, const compiled_block *block, uint8_t *bytes) {
+	native_emitter emitter = {bytes, 0};
+	
+	// offsets of jumps to block exit and to decoding next operation
+	int exit_jumps[block->length * 2];
+	int exit_jump_count = 0;
+	int decode_jumps[block->length];
+	int decode_jump_count = 0;
+	
+	// save callee saved registers, which also aligns stack for calls, and
+	// keep arguments in them
+	emit_push(&emitter, REGISTER_CONSOLE);
+	emit_push(&emitter, REGISTER_MPU);
+	emit_push(&emitter, REGISTER_RECOMPILER);
+	emit_push(&emitter, REGISTER_CYCLES);
+	emit_push(&emitter, REGISTER_COUNT);
+	emit_register_operation(&emitter, true, 0x89, REGISTER_RDI, REGISTER_CONSOLE);
+	emit_register_operation(&emitter, true, 0x89, REGISTER_RSI, REGISTER_RECOMPILER);
+	emit_register_operation(&emitter, false, 0x89, REGISTER_RDX, REGISTER_CYCLES);
+	emit_memory_operation(&emitter, true, 0x8b, REGISTER_MPU, REGISTER_CONSOLE, CONSOLE_FIELD(mpu));
+	emit_register_operation(&emitter, false, 0x31, REGISTER_COUNT, REGISTER_COUNT);
+	
+	for (int index = 0; index < block->length; ++index) {
+		const compiled_operation *operation = &block->operations[index];
+		
+		// stop, unless MPU is ready
+		emit_memory_operation(&emitter, false, 0x80, 7, REGISTER_MPU, MPU_FIELD(is_ready));
+		emit_byte(&emitter, 0x00);
+		exit_jumps[exit_jump_count++] = emit_jump(&emitter, CONDITION_EQUAL);
+		
+		// stop, unless remaining cycles of the operation fit
+		emit_memory_operation(&emitter, false, 0x8b, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(operation.duration));
+		emit_memory_operation(&emitter, false, 0x2b, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(operation_clock));
+		
+		// lea ecx, [r15 + rax]; cmp ecx, r14d
+		emit_byte(&emitter, 0x41);
+		emit_byte(&emitter, 0x8d);
+		emit_byte(&emitter, 0x0c);
+		emit_byte(&emitter, 0x07);
+		emit_register_operation(&emitter, false, 0x39, REGISTER_CYCLES, REGISTER_RCX);
+		exit_jumps[exit_jump_count++] = emit_jump(&emitter, CONDITION_GREATER);
+		
+		// TIA and RIOT lag behind, same as when interpreting a block
+		emit_memory_operation(&emitter, false, 0x01, REGISTER_RAX, REGISTER_CONSOLE, CONSOLE_FIELD(tia_lag));
+		emit_memory_operation(&emitter, false, 0x01, REGISTER_RAX, REGISTER_CONSOLE, CONSOLE_FIELD(riot_lag));
+		emit_register_operation(&emitter, false, 0x89, REGISTER_RCX, REGISTER_COUNT);
+		
+		// execute current operation
+		emit_memory_operation(&emitter, false, 0x8b, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(operation.length));
+		emit_memory_operation(&emitter, false, 0x01, REGISTER_RAX, REGISTER_MPU, MPU_FIELD(program_counter));
+		emit_execute(&emitter, operation);
+		emit_store_immediate(&emitter, REGISTER_MPU, MPU_FIELD(operation_clock), 0);
+		
+		// the last operation decodes the next one anew
+		if (index + 1 == block->length) {
+			break;
+		}
+		
+		// so does an operation, after which its bank is switched out
+		// cmp dword [bank_index], block bank index
+		emit_load_pointer(&emitter, REGISTER_RAX, recompiler->bank_index);
+		emit_byte(&emitter, 0x81);
+		emit_byte(&emitter, 0x38);
+		emit_int32(&emitter, block->bank_index);
+		decode_jumps[decode_jump_count++] = emit_jump(&emitter, CONDITION_NOT_EQUAL);
+		
+		// record decode lookup in differential mode
+		emit_memory_operation(&emitter, false, 0x80, 7, REGISTER_RECOMPILER, offsetof(racer_recompiler, is_recording));
+		emit_byte(&emitter, 0x00);
+		const int skip_jump = emit_jump(&emitter, CONDITION_EQUAL);
+		emit_register_operation(&emitter, true, 0x89, REGISTER_RECOMPILER, REGISTER_RDI);
+		emit_register_operation(&emitter, true, 0x89, REGISTER_MPU, REGISTER_RSI);
+		emit_call(&emitter, (const void *)record_next_decode);
+		patch_jumps(&emitter, &skip_jump, 1);
+		
+		emit_resolve(&emitter, operation + 1);
+	}
+	
+	// decode next operation
+	patch_jumps(&emitter, decode_jumps, decode_jump_count);
+	emit_register_operation(&emitter, true, 0x89, REGISTER_MPU, REGISTER_RDI);
+	emit_call(&emitter, (const void *)racer_mcs6507_decode_operation);
+	
+	// return cycle count, restoring callee saved registers
+	patch_jumps(&emitter, exit_jumps, exit_jump_count);
+	emit_register_operation(&emitter, false, 0x89, REGISTER_COUNT, REGISTER_RAX);
+	emit_pop(&emitter, REGISTER_COUNT);
+	emit_pop(&emitter, REGISTER_CYCLES);
+	emit_pop(&emitter, REGISTER_RECOMPILER);
+	emit_pop(&emitter, REGISTER_MPU);
+	emit_pop(&emitter, REGISTER_CONSOLE);
+	emit_byte(&emitter, 0xc3);
+	
+	return emitter.size;
+}
+
+/// Maps executable memory of the specified recompiler, which is never writable and executable at once
+/// (W^X): it is mapped executable, and made writable only while native code is emitted.
+///
+/// Returns whether memory is mapped.
+static bool map_native_code(racer_recompiler *recompiler) {
+#if defined(MAP_JIT)
+	// memory mapped for JIT is toggled between writable and executable for
+	// the current thread instead
+	void *code = mmap(NULL, NATIVE_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS | MAP_JIT, -1, 0);
+	if (code == MAP_FAILED) {
+		return false;
+	}
+#else
+	void *code = mmap(NULL, NATIVE_CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (code == MAP_FAILED) {
+		return false;
+	}
+	if (mprotect(code, NATIVE_CODE_SIZE, PROT_READ | PROT_EXEC) != 0) {
+		munmap(code, NATIVE_CODE_SIZE);
+		return false;
+	}
+#endif
+	
+	recompiler->native_code = (uint8_t *)code;
+	recompiler->native_code_size = NATIVE_CODE_SIZE;
+	return true;
+}
+
+/// Makes executable memory of the specified recompiler between the specified offsets either writable,
+/// or executable again.
+///
+/// Returns whether protection changed.
+static bool protect_native_code(racer_recompiler *recompiler, size_t start, size_t end, bool is_writable) {
+#if defined(MAP_JIT)
+	pthread_jit_write_protect_np(!is_writable);
+	return true;
+#else
+	const size_t page_start = start & ~((size_t)sysconf(_SC_PAGESIZE) - 1);
+	const int protection = is_writable ? (PROT_READ | PROT_WRITE) : (PROT_READ | PROT_EXEC);
+	return mprotect(recompiler->native_code + page_start, end - page_start, protection) == 0;
+#endif
+}
+
+/// Stops running native code of all compiled blocks of the specified recompiler, which run as
+/// threaded code from now on.
+static void disable_native_code(racer_recompiler *recompiler) {
+	for (int offset = 0; offset < recompiler->program->size; ++offset) {
+		if (recompiler->blocks[offset] != NULL) {
+			recompiler->blocks[offset]->native = NULL;
+		}
+	}
+	recompiler->native_code_count = recompiler->native_code_size;
+}
+
+/// Emits native code of the specified compiled block into executable memory of the specified
+/// recompiler; returns `NULL` when executable memory is unavailable or full.
+static native_block compile_native_block(racer_recompiler *recompiler, const compiled_block *block) {
+	if (recompiler->native_code == NULL && !map_native_code(recompiler)) {
+		return NULL;
+	}
+	
+	const size_t start = recompiler->native_code_count;
+	const size_t end = start + (block->length + 2) * MAX_NATIVE_OPERATION_SIZE;
+	if (end > recompiler->native_code_size || !protect_native_code(recompiler, start, end, true)) {
+		return NULL;
+	}
+	
+	uint8_t *bytes = &recompiler->native_code[start];
+	recompiler->native_code_count += emit_native_block(recompiler, block, bytes);
+	
+	// pages, which are left writable, may hold native code of other blocks
+	if (!protect_native_code(recompiler, start, end, false)) {
+		disable_native_code(recompiler);
+		return NULL;
+	}
+	
+	// start every block at a 16-byte boundary
+	recompiler->native_code_count = (recompiler->native_code_count + 0xf) & ~(size_t)0xf;
+	return (native_block)(void *)bytes;
+}
+
+/// Releases executable memory of the specified recompiler.
+static void release_native_code(racer_recompiler *recompiler) {
+	if (recompiler->native_code != NULL) {
+		munmap(recompiler->native_code, recompiler->native_code_size);
+	}
+}
+
+#else
+
+static native_block compile_native_block(racer_recompiler *recompiler, const compiled_block *block) {
+	// compiled blocks run as threaded code only
+	return NULL;
+}
+
+static void release_native_code(racer_recompiler *recompiler) {
+	// there is no executable memory to release
+}
+
+#endif
+
+
+// MARK: -
+// MARK: Compilation
+
+/// Compiles basic block, which starts at the specified cartridge program offset.
+static compiled_block *compile_block(racer_recompiler *recompiler, int offset) {
+	const predecoded *operation = &recompiler->program->operations[offset];
+	const int length = operation->block_length;
+	
+	compiled_block *block = (compiled_block *)malloc(sizeof(compiled_block) + length * sizeof(compiled_operation));
+	block->bank_index = *recompiler->bank_index;
+	block->length = length;
+	block->is_different = false;
+	
+	for (int index = 0; index < length; ++index) {
+		block->operations[index] = (compiled_operation){
+			.operation = operation,
+			.handlers = racer_mcs6507_get_handlers(operation)
+		};
+		
+		// operations of a block are laid out by their length in a program
+		operation += operation->length;
+	}
+	
+	block->native = compile_native_block(recompiler, block);
+	return block;
+}
+
+racer_recompiler *racer_recompiler_create(const racer_cartridge_program *program, const int *bank_index) {
+	racer_recompiler *recompiler = (racer_recompiler *)malloc(sizeof(racer_recompiler));
+	recompiler->program = program;
+	recompiler->bank_index = bank_index;
+	
+	recompiler->blocks = (compiled_block **)calloc(program->size, sizeof(compiled_block *));
+	recompiler->heat = (uint8_t *)calloc(program->size, sizeof(uint8_t));
+	recompiler->is_translated_different = (bool *)calloc(program->size, sizeof(bool));
+	
+	recompiler->event_count = 0;
+	recompiler->event_index = 0;
+	recompiler->is_recording = false;
+	recompiler->is_translated = false;
+	recompiler->recorded_bank_index = 0;
+	recompiler->is_different = false;
+	recompiler->difference = NULL;
+	
+	recompiler->native_code = NULL;
+	recompiler->native_code_size = 0;
+	recompiler->native_code_count = 0;
+	
+	return recompiler;
+}
+
+void racer_recompiler_destroy(racer_recompiler *recompiler) {
+	for (int offset = 0; offset < recompiler->program->size; ++offset) {
+		free(recompiler->blocks[offset]);
+	}
+	
+	free(recompiler->blocks);
+	free(recompiler->heat);
+	free(recompiler->is_translated_different);
+	release_native_code(recompiler);
+	free(recompiler);
+}
+
+
+// MARK: -
+// MARK: Execution
+
+/// Runs the specified compiled block from its first operation, which must be the current MPU
+/// operation.
+static int run_compiled_block(racer_recompiler *recompiler, const compiled_block *block, racer_atari2600 *console, int cycles) {
+	racer_mcs6507 *mpu = console->mpu;
+	
+	int count = 0;
+	for (int index = 0; index < block->length && mpu->is_ready; ++index) {
+		const int remaining_cycles = mpu->operation.duration - mpu->operation_clock;
+		if (count + remaining_cycles > cycles) {
+			break;
+		}
+		
+		// NOTE: same as when interpreting a block, TIA and RIOT lag behind
+		// until MPU accesses either of them or the block ends
+		console->tia_lag += remaining_cycles;
+		console->riot_lag += remaining_cycles;
+		count += remaining_cycles;
+		
+		// execute current operation
+		const compiled_operation *operation = &block->operations[index];
+		mpu->program_counter += mpu->operation.length;
+		operation->handlers.execute(mpu, mpu->operation.address);
+		mpu->operation_clock = 0;
+		
+		// resolve next operation, unless the block ends or its bank has
+		// been switched out, in which case next operation is decoded anew
+		if (index + 1 < block->length && *recompiler->bank_index == block->bank_index) {
+			const compiled_operation *next = operation + 1;
+			record_next_decode(recompiler, mpu);
+			next->handlers.resolve(mpu, next->operation);
+		} else {
+			racer_mcs6507_decode_operation(mpu);
+			break;
+		}
+	}
+	
+	return count;
+}
+
+/// Runs the specified compiled block, as native code when there is such.
+static int run_block(racer_recompiler *recompiler, const compiled_block *block, racer_atari2600 *console, int cycles) {
+	if (block->native != NULL) {
+		return block->native(console, recompiler, cycles);
+	} else {
+		return run_compiled_block(recompiler, block, console, cycles);
+	}
+}
+
+
+// MARK: -
+// MARK: Differential mode
+
+void racer_recompiler_record_read(racer_recompiler *recompiler, int address, uint8_t data) {
+	if (recompiler->is_recording && recompiler->event_count < MAX_BLOCK_EVENTS) {
+		recompiler->events[recompiler->event_count++] = (event){EVENT_READ, address, data};
+	}
+}
+
+void racer_recompiler_record_write(racer_recompiler *recompiler, int address, uint8_t data) {
+	if (recompiler->is_recording && recompiler->event_count < MAX_BLOCK_EVENTS) {
+		recompiler->events[recompiler->event_count++] = (event){EVENT_WRITE, address, data};
+	}
+}
+
+void racer_recompiler_record_decode(racer_recompiler *recompiler, int address, int offset) {
+	if (recompiler->is_recording && recompiler->event_count < MAX_BLOCK_EVENTS) {
+		recompiler->events[recompiler->event_count++] = (event){EVENT_DECODE, address, offset};
+	}
+}
+
+/// Reports difference between compiled or translated and interpreted block, unless one has already
+/// been reported for the block.
+static void report_difference(racer_recompiler *recompiler, const char *description, int address) {
+	if (recompiler->is_different) {
+		return;
+	}
+	
+	const char *code = recompiler->is_translated ? "translated" : "compiled";
+	fprintf(stderr, "racer_recompiler: %s and interpreted code differ: %s at $%04x.\n", code, description, address);
+	recompiler->is_different = true;
+	if (recompiler->difference == NULL) {
+		recompiler->difference = description;
+	}
+}
+
+/// Returns the next recorded bus access, verifying it matches the specified type and address.
+///
+/// Returns a placeholder access, which reads $ff and looks up no predecoded operation, when there are
+/// no more recorded accesses.
+static const event *replay_event(racer_recompiler *recompiler, event_type type, int address) {
+	static const event missing_event = {EVENT_READ, 0x0000, -1};
+	if (recompiler->event_index == recompiler->event_count) {
+		report_difference(recompiler, "extra bus access", address);
+		return &missing_event;
+	}
+	
+	const event *next = &recompiler->events[recompiler->event_index++];
+	if (next->type != type || next->address != address) {
+		report_difference(recompiler, "different bus access", address);
+	}
+	
+	return next;
+}
+
+static uint8_t replay_read_bus(void *bus, int address) {
+	racer_recompiler *recompiler = (racer_recompiler *)bus;
+	return replay_event(recompiler, EVENT_READ, address)->data;
+}
+
+static void replay_write_bus(void *bus, int address, uint8_t data) {
+	racer_recompiler *recompiler = (racer_recompiler *)bus;
+	if (replay_event(recompiler, EVENT_WRITE, address)->data != data) {
+		report_difference(recompiler, "different data written", address);
+	}
+}
+
+static const predecoded *replay_read_predecoded(void *bus, int address) {
+	racer_recompiler *recompiler = (racer_recompiler *)bus;
+	
+	// translated blocks only look up operations they decode from the bus;
+	// the ones they continue with are in the bank they started in, and are
+	// verified along with the rest of MPU state
+	int offset;
+	const event *next = &recompiler->events[recompiler->event_index];
+	if (recompiler->is_translated
+		&& (recompiler->event_index == recompiler->event_count || next->type != EVENT_DECODE || next->address != address)) {
+		offset = get_program_offset(recompiler, address, recompiler->recorded_bank_index);
+	} else {
+		offset = replay_event(recompiler, EVENT_DECODE, address)->data;
+	}
+	if (offset < 0 || offset >= recompiler->program->size) {
+		return NULL;
+	}
+	
+	const predecoded *operation = &recompiler->program->operations[offset];
+	return (operation->length > 0) ? operation : NULL;
+}
+
+/// Interprets operations from the specified MPU state against recorded bus accesses for the specified
+/// number of cycles, and verifies the result matches the specified compiled MPU state.
+///
+/// Returns whether compiled and interpreted block differ.
+static bool verify_compiled_block(racer_recompiler *recompiler, racer_mcs6507 interpreted, const racer_mcs6507 *compiled, int cycles) {
+	interpreted.bus = recompiler;
+	interpreted.read_bus = replay_read_bus;
+	interpreted.write_bus = replay_write_bus;
+	interpreted.read_predecoded = replay_read_predecoded;
+	recompiler->event_index = 0;
+	
+	int count = 0;
+	while (count < cycles) {
+		count += interpreted.operation.duration - interpreted.operation_clock;
+		racer_mcs6507_complete_operation(&interpreted);
+	}
+	
+	if (count != cycles) {
+		report_difference(recompiler, "different cycle count", compiled->program_counter);
+	}
+	if (recompiler->event_index != recompiler->event_count) {
+		report_difference(recompiler, "missing bus access", compiled->program_counter);
+	}
+	if (interpreted.accumulator != compiled->accumulator
+		|| interpreted.x != compiled->x
+		|| interpreted.y != compiled->y
+		|| racer_mcs6507_get_status(&interpreted) != racer_mcs6507_get_status(compiled)
+		|| interpreted.stack_pointer != compiled->stack_pointer
+		|| interpreted.program_counter != compiled->program_counter
+		|| interpreted.operation.code != compiled->operation.code
+		|| interpreted.operation.address != compiled->operation.address
+		|| interpreted.operation.duration != compiled->operation.duration
+		|| interpreted.operation.length != compiled->operation.length
+		|| interpreted.operation_clock != compiled->operation_clock) {
+		report_difference(recompiler, "different MPU state", compiled->program_counter);
+	}
+	
+	return recompiler->is_different;
+}
+
+/// Starts recording bus accesses of a compiled or translated block.
+static void start_recording(racer_recompiler *recompiler, bool is_translated) {
+	recompiler->event_count = 0;
+	recompiler->is_recording = true;
+	recompiler->is_translated = is_translated;
+	recompiler->recorded_bank_index = *recompiler->bank_index;
+	recompiler->is_different = false;
+}
+
+/// Stops recording bus accesses of a block, which ran from the specified MPU state for the specified
+/// number of cycles, and verifies them against interpreting the block.
+///
+/// Returns whether the block and the interpreter differ.
+static bool verify_recording(racer_recompiler *recompiler, const racer_mcs6507 *state, const racer_mcs6507 *mpu, int cycles) {
+	recompiler->is_recording = false;
+	if (recompiler->event_count == MAX_BLOCK_EVENTS) {
+		report_difference(recompiler, "too many bus accesses", state->program_counter);
+		return true;
+	}
+	
+	return verify_compiled_block(recompiler, *state, mpu, cycles);
+}
+
+int racer_recompiler_run_block(racer_recompiler *recompiler, racer_atari2600 *console, int cycles, bool is_differential) {
+	racer_mcs6507 *mpu = console->mpu;
+	const int offset = console->map_cartridge(console->cartridge, mpu->program_counter & 0xfff);
+	
+	// compile block once it becomes hot
+	compiled_block *block = recompiler->blocks[offset];
+	if (block == NULL) {
+		if (recompiler->program->operations[offset].length == 0
+			|| ++recompiler->heat[offset] < HOT_BLOCK_THRESHOLD) {
+			return 0;
+		}
+		
+		block = compile_block(recompiler, offset);
+		recompiler->blocks[offset] = block;
+	}
+	
+	// NOTE: current operation is decoded before it starts, so it can differ
+	// from the one in the block when its bank was switched in between;
+	// compiled block only executes it correctly when operation codes match
+	if (block->operations[0].operation->code != mpu->operation.code || block->is_different) {
+		return 0;
+	}
+	
+	if (!is_differential) {
+		return run_block(recompiler, block, console, cycles);
+	}
+	
+	// leave a block, which differs, to the interpreter from now on
+	const racer_mcs6507 state = *mpu;
+	start_recording(recompiler, false);
+	const int count = run_block(recompiler, block, console, cycles);
+	block->is_different = verify_recording(recompiler, &state, mpu, count);
+	
+	return count;
+}
+
+int racer_recompiler_run_translated_block(racer_recompiler *recompiler, racer_atari2600 *console, racer_translated_block block, int cycles) {
+	racer_mcs6507 *mpu = console->mpu;
+	const int offset = console->map_cartridge(console->cartridge, mpu->program_counter & 0xfff);
+	if (recompiler->is_translated_different[offset]) {
+		return 0;
+	}
+	
+	// same as a compiled block, leave a translated block, which differs,
+	// to the interpreter from now on
+	const racer_mcs6507 state = *mpu;
+	start_recording(recompiler, true);
+	const int count = block(console, recompiler->bank_index, cycles);
+	recompiler->is_translated_different[offset] = verify_recording(recompiler, &state, mpu, count);
+	
+	return count;
+}
+
+const char *racer_recompiler_get_difference(const racer_recompiler *recompiler) {
+	return recompiler->difference;
+}
@@ -0,0 +1,74 @@
+//
+//  recompiler.h
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#ifndef recompiler_h
+#define recompiler_h
+
+#include <stdbool.h>
+
+#include "atari2600.h"
+#include "translator.h"
+
+/// Recompiler of cartridge code into native code.
+///
+/// Basic blocks of a predecoded cartridge program are compiled, once they become hot, into x86-64
+/// machine code, which runs without looking up or dispatching on operations: register transfers,
+/// status flag changes and loads and stores at fixed RAM addresses are compiled inline, and the rest
+/// into direct calls to operation handlers. On other architectures, or when executable memory is
+/// unavailable, blocks are compiled into threaded code (i.e. sequences of operation handlers)
+/// instead. Compiled blocks are keyed by cartridge bank and offset, so they remain valid across bank
+/// switches; a block stops early when its bank is switched out while it runs. Code outside cartridge
+/// ROM is never compiled, which leaves self-modifying RAM code to the interpreter.
+typedef struct racer_recompiler racer_recompiler;
+
+/// Creates recompiler for the specified predecoded cartridge program.
+///
+/// The specified bank index must point to the index of currently selected cartridge bank; it is
+/// checked to stop compiled blocks, once their bank is switched out.
+racer_recompiler *racer_recompiler_create(const racer_cartridge_program *program, const int *bank_index);
+
+/// Destroys the specified recompiler and all its compiled blocks.
+void racer_recompiler_destroy(racer_recompiler *recompiler);
+
+/// Runs compiled basic block, which starts at the current MPU operation of the specified console,
+/// but no longer than the specified number of cycles.
+///
+/// TIA and RIOT clocks are left lagging behind MPU clock, the same as when interpreting a block.
+/// Returns the number of advanced cycles; returns 0 when no compiled block starts at the current
+/// operation (yet).
+///
+/// In differential mode, bus accesses of the compiled block are recorded and the same block is
+/// then interpreted against the recording, from the same MPU state; any difference in bus accesses,
+/// MPU state or cycle count between the two is reported to standard error, and the block is left to
+/// the interpreter from then on.
+int racer_recompiler_run_block(racer_recompiler *recompiler, racer_atari2600 *console, int cycles, bool is_differential);
+
+/// Runs the specified translated basic block, which starts at the current MPU operation of the
+/// specified console, in differential mode, but no longer than the specified number of cycles.
+///
+/// Bus accesses of the translated block are recorded and verified against the interpreter, the same
+/// as of a compiled block in differential mode. Returns the number of advanced cycles; returns 0
+/// when the block has differed before, and is left to the interpreter.
+int racer_recompiler_run_translated_block(racer_recompiler *recompiler, racer_atari2600 *console, racer_translated_block block, int cycles);
+
+/// Returns description of the first difference between compiled or translated and interpreted code
+/// found in differential mode; `NULL` when there is none.
+const char *racer_recompiler_get_difference(const racer_recompiler *recompiler);
+
+/// Records read of the specified data at the specified bus address, when differential mode is
+/// recording.
+void racer_recompiler_record_read(racer_recompiler *recompiler, int address, uint8_t data);
+
+/// Records write of the specified data at the specified bus address, when differential mode is
+/// recording.
+void racer_recompiler_record_write(racer_recompiler *recompiler, int address, uint8_t data);
+
+/// Records lookup of a predecoded operation at the specified bus address and cartridge program offset
+/// (-1 when the address is outside cartridge ROM), when differential mode is recording.
+void racer_recompiler_record_decode(racer_recompiler *recompiler, int address, int offset);
+
+#endif /* recompiler_h */
@@ -21,33 +21,178 @@ typedef enum {
 	RACER_THREAD_STOPPED
 } racer_thread_state;
 
+// buffer index of published field, with a flag denoting that it has not
+// been acquired yet
+#define FIELD_INDEX_MASK 0x3
+#define FIELD_PUBLISHED (1<<2)
+
+// time before a paced field is due, which emulation spins for instead
+// of sleeping, in nanoseconds
+#define PACING_SPIN_TIME 300000
+
+// the number of the most recent field intervals pacing statistics are
+// taken from
+#define FIELD_INTERVAL_COUNT 256
+
 struct racer_thread {
 	racer_atari2600 *console;
-	uint8_t *buffer;
+	uint8_t *buffers[RACER_THREAD_BUFFER_COUNT];
 	size_t buffer_size;
 
+	// triple buffering: emulation draws into the back buffer, consumer
+	// reads from the front one, and they swap fields through the middle
+	// one without either ever waiting for the other; the front buffer is
+	// only swapped once every acquisition of it has been released
+	int back_index;
+	_Atomic int middle_index;
+	int front_index;
+	_Atomic int front_use_count;
+
+	_Atomic long dropped_field_count;
+	_Atomic long duplicated_field_count;
+
+	// pacing: interval between fields (0 when not paced), and the time
+	// the current field is due; pacing restarts when resumed
+	_Atomic int64_t field_interval;
+	int64_t field_due_time;
+	int64_t field_publish_time;
+	_Atomic bool is_pacing_reset;
+
+	_Atomic int64_t field_intervals[FIELD_INTERVAL_COUNT];
+	_Atomic long field_interval_count;
+	_Atomic long overrun_count;
+
+	// turbo: publish every n-th field (0 when off), rendering only those,
+	// while running as fast as possible; render mode requested by the host
+	// is applied by emulation at sync, and overridden while turbo is on
+	_Atomic int turbo_decimation;
+	long field_index;
+	bool is_field_rendered;
+	bool is_next_field_rendered;
+	_Atomic racer_tia_render_mode host_render_mode;
+
 	_Atomic racer_thread_state state;
 	pthread_t handle;
 	pthread_mutex_t mutex;
 	pthread_cond_t pause;
 
-	double field_time;
-	struct timespec field_start_time;
+	// smoothed field times are read by the host, while emulation updates
+	// them; the time emulation resumed at (0 when it has already been
+	// taken), which emulation restarts timing fields from
+	_Atomic double field_time;
+	int64_t field_start_time;
+	_Atomic double emulated_field_time;
+	int64_t emulated_field_start_time;
+	_Atomic int64_t resume_time;
 };
 
-static void update_field_rate(racer_thread *thread) {
-	struct timespec current_time;
-	clock_gettime(CLOCK_MONOTONIC, &current_time);
+static int64_t get_time(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+static void pace_field(racer_thread *thread) {
+	const bool is_turbo = atomic_load_explicit(&thread->turbo_decimation, memory_order_relaxed) > 0;
+	const int64_t interval = is_turbo ? 0 : atomic_load_explicit(&thread->field_interval, memory_order_relaxed);
+	int64_t time = get_time();
+	if (atomic_exchange_explicit(&thread->is_pacing_reset, false, memory_order_relaxed)) {
+		thread->field_due_time = time + interval;
+		thread->field_publish_time = 0;
+	}
+
+	if (interval > 0) {
+		if (time > thread->field_due_time) {
+			atomic_fetch_add_explicit(&thread->overrun_count, 1, memory_order_relaxed);
+		}
+
+		// sleep coarsely, and spin until the field is due
+		const int64_t sleep_time = thread->field_due_time - PACING_SPIN_TIME - time;
+		if (sleep_time > 0) {
+			nanosleep(&(struct timespec){sleep_time / 1000000000, sleep_time % 1000000000}, NULL);
+		}
+		while ((time = get_time()) < thread->field_due_time) {
+			// spin
+		}
+
+		// restart pacing, rather than catching up, when falling behind by
+		// more than a field
+		thread->field_due_time += interval;
+		if (thread->field_due_time < time) {
+			thread->field_due_time = time + interval;
+		}
+	}
+
+	// record interval since the previous field
+	if (thread->field_publish_time != 0) {
+		const long count = atomic_load_explicit(&thread->field_interval_count, memory_order_relaxed);
+		atomic_store_explicit(&thread->field_intervals[count % FIELD_INTERVAL_COUNT], time - thread->field_publish_time, memory_order_relaxed);
+		atomic_store_explicit(&thread->field_interval_count, count + 1, memory_order_relaxed);
+	}
+	thread->field_publish_time = time;
+}
 
-	// adding 1 guards against
-	long seconds = current_time.tv_sec - thread->field_start_time.tv_sec;
-	long nanoseconds = current_time.tv_nsec - thread->field_start_time.tv_nsec;
-	long field_time = seconds * 1000000000 + nanoseconds;
+static void update_field_rate(_Atomic double *smoothed_field_time, int64_t *field_start_time) {
+	const int64_t current_time = get_time();
+	const int64_t field_time = current_time - *field_start_time;
 
 	// fps = (α⋅time) + ((1-α)⋅time)
 	// α = 0.1, smoothing factor
-	thread->field_time *= 0.9;
-	thread->field_time += 0.1 * (double)field_time;
+	const double smoothed_time = atomic_load_explicit(smoothed_field_time, memory_order_relaxed);
+	atomic_store_explicit(smoothed_field_time, 0.9 * smoothed_time + 0.1 * (double)field_time, memory_order_relaxed);
+	*field_start_time = current_time;
+}
+
+static bool select_render_mode(racer_thread *thread) {
+	// TIA has already switched to render mode of the field, which just
+	// started, so select render mode of the one after it
+	racer_tia *tia = thread->console->tia;
+	const bool was_field_rendered = thread->is_field_rendered;
+	thread->is_field_rendered = thread->is_next_field_rendered;
+	thread->field_index += 1;
+
+	// without turbo, every field is published in render mode of the host
+	const racer_tia_render_mode host_mode = atomic_load_explicit(&thread->host_render_mode, memory_order_relaxed);
+	const int decimation = atomic_load_explicit(&thread->turbo_decimation, memory_order_relaxed);
+	if (decimation == 0) {
+		racer_tia_set_render_mode(tia, host_mode);
+		thread->is_next_field_rendered = true;
+		return was_field_rendered;
+	}
+
+	// fields, which are not published in turbo, only draw collisions,
+	// unless the host turned rendering off altogether
+	const racer_tia_render_mode skipped_mode = (host_mode == TIA_RENDER_OFF) ? TIA_RENDER_OFF : TIA_RENDER_COLLISIONS;
+	thread->is_next_field_rendered = (thread->field_index + 1) % decimation == 0;
+	racer_tia_set_render_mode(tia, thread->is_next_field_rendered ? host_mode : skipped_mode);
+
+	return was_field_rendered;
+}
+
+static void reset_video_buffer(racer_thread *thread) {
+	racer_tia *tia = thread->console->tia;
+	tia->video_buffer = thread->buffers[thread->back_index];
+	tia->video_buffer_end = tia->video_buffer + thread->buffer_size;
+}
+
+static void publish_field(racer_thread *thread) {
+	// swap completed back buffer with the middle one; a field, which
+	// is still published there, has never been acquired
+	const int published = thread->back_index | FIELD_PUBLISHED;
+	const int middle = atomic_exchange_explicit(&thread->middle_index, published, memory_order_acq_rel);
+	if (middle & FIELD_PUBLISHED) {
+		atomic_fetch_add_explicit(&thread->dropped_field_count, 1, memory_order_relaxed);
+	}
+	thread->back_index = middle & FIELD_INDEX_MASK;
+}
+
+static void restart_field_time(racer_thread *thread) {
+	// time fields from when emulation resumed, rather than paused
+	const int64_t resume_time = atomic_exchange_explicit(&thread->resume_time, 0, memory_order_relaxed);
+	if (resume_time != 0) {
+		thread->field_start_time = resume_time;
+		thread->emulated_field_start_time = resume_time;
+	}
 }
 
 static void sync_video(const void *output, racer_video_sync sync) {
@@ -57,13 +202,17 @@ static void sync_video(const void *output, racer_video_sync sync) {
 	}
 
 	racer_thread *thread = (racer_thread *)output;
-	racer_thread_pause(thread);
-	// update field rate
-	update_field_rate(thread);
+	restart_field_time(thread);
+	update_field_rate(&thread->emulated_field_time, &thread->emulated_field_start_time);
+	if (select_render_mode(thread)) {
+		pace_field(thread);
+		publish_field(thread);
+		// update field rate
+		update_field_rate(&thread->field_time, &thread->field_start_time);
+	}
 
 	// reset TIA video ooutput buffer
-	thread->console->tia->video_buffer = thread->buffer;
-	thread->console->tia->video_buffer_end = thread->buffer + thread->buffer_size;
+	reset_video_buffer(thread);
 }
 
 static void await_resume(racer_thread *thread) {
@@ -80,7 +229,7 @@ static void * run_loop(void *data) {
 		racer_thread_state state = atomic_load_explicit(&thread->state, memory_order_relaxed);
 		switch (state) {
 			case RACER_THREAD_RUNNING:
-				racer_atari2600_advance_clock(thread->console);
+				racer_atari2600_run_frame(thread->console);
 				break;
 			case RACER_THREAD_PAUSED:
 				await_resume(thread);
@@ -95,18 +244,41 @@ static void * run_loop(void *data) {
 	return NULL;
 }
 
-racer_thread * racer_thread_create(racer_atari2600 *console, uint8_t *buffer, size_t buffer_size) {
+racer_thread * racer_thread_create(racer_atari2600 *console, uint8_t *const buffers[RACER_THREAD_BUFFER_COUNT], size_t buffer_size) {
 	racer_thread *thread = malloc(sizeof(racer_thread));
-	thread->buffer = buffer;
+	for (int index = 0; index < RACER_THREAD_BUFFER_COUNT; ++index) {
+		thread->buffers[index] = buffers[index];
+	}
 	thread->buffer_size = buffer_size;
 
+	thread->back_index = 0;
+	atomic_store_explicit(&thread->middle_index, 1, memory_order_relaxed);
+	thread->front_index = 2;
+	atomic_store_explicit(&thread->front_use_count, 0, memory_order_relaxed);
+	atomic_store_explicit(&thread->dropped_field_count, 0, memory_order_relaxed);
+	atomic_store_explicit(&thread->duplicated_field_count, 0, memory_order_relaxed);
+
+	atomic_store_explicit(&thread->field_interval, 0, memory_order_relaxed);
+	atomic_store_explicit(&thread->is_pacing_reset, true, memory_order_relaxed);
+	atomic_store_explicit(&thread->field_interval_count, 0, memory_order_relaxed);
+	atomic_store_explicit(&thread->overrun_count, 0, memory_order_relaxed);
+
+	atomic_store_explicit(&thread->turbo_decimation, 0, memory_order_relaxed);
+	thread->field_index = 0;
+	thread->is_field_rendered = true;
+	thread->is_next_field_rendered = true;
+	atomic_store_explicit(&thread->host_render_mode, console->tia->next_render_mode, memory_order_relaxed);
+
 	thread->console = console;
 	thread->console->tia->video_output = thread;
 	thread->console->tia->sync_video = sync_video;
-	sync_video(thread, VIDEO_BUFFER_SYNC);
+	reset_video_buffer(thread);
 
-	thread->field_time = DBL_MIN;
-	clock_gettime(CLOCK_MONOTONIC, &thread->field_start_time);
+	atomic_store_explicit(&thread->field_time, DBL_MIN, memory_order_relaxed);
+	thread->field_start_time = get_time();
+	atomic_store_explicit(&thread->emulated_field_time, DBL_MIN, memory_order_relaxed);
+	thread->emulated_field_start_time = thread->field_start_time;
+	atomic_store_explicit(&thread->resume_time, 0, memory_order_relaxed);
 
 	atomic_store_explicit(&thread->state, RACER_THREAD_PAUSED, memory_order_relaxed);
 	pthread_mutex_init(&thread->mutex, NULL);
@@ -117,8 +289,11 @@ racer_thread * racer_thread_create(racer_atari2600 *console, uint8_t *buffer, si
 }
 
 void racer_thread_destroy(racer_thread *thread) {
-	// notify run loop to break
+	// notify run loop to break, waking it up when paused
+	pthread_mutex_lock(&thread->mutex);
 	atomic_store_explicit(&thread->state, RACER_THREAD_STOPPED, memory_order_relaxed);
+	pthread_cond_signal(&thread->pause);
+	pthread_mutex_unlock(&thread->mutex);
 
 	// wait for thread to stop and clean up resources
 	pthread_join(thread->handle, NULL);
@@ -128,13 +303,11 @@ void racer_thread_destroy(racer_thread *thread) {
 }
 
 void racer_thread_resume(racer_thread *thread) {
+	atomic_store_explicit(&thread->is_pacing_reset, true, memory_order_relaxed);
+	atomic_store_explicit(&thread->resume_time, get_time(), memory_order_relaxed);
 	atomic_store_explicit(&thread->state, RACER_THREAD_RUNNING, memory_order_relaxed);
 
 	pthread_mutex_lock(&thread->mutex);
-	struct timespec current_time;
-	clock_gettime(CLOCK_MONOTONIC, &current_time);
-	thread->field_start_time = current_time;
-
 	pthread_cond_signal(&thread->pause);
 	pthread_mutex_unlock(&thread->mutex);
 }
@@ -149,5 +322,79 @@ bool racer_thread_is_paused(racer_thread *thread) {
 }
 
 long int racer_thread_get_field_time(racer_thread *thread) {
-	return (long int)thread->field_time;
+	return (long int)atomic_load_explicit(&thread->field_time, memory_order_relaxed);
+}
+
+long int racer_thread_get_emulated_field_time(racer_thread *thread) {
+	return (long int)atomic_load_explicit(&thread->emulated_field_time, memory_order_relaxed);
+}
+
+int racer_thread_acquire_field(racer_thread *thread) {
+	// swap front buffer with the middle one only when it holds a newly
+	// published field, and the consumer is no longer reading it, otherwise
+	// keep presenting the same field
+	const int middle = atomic_load_explicit(&thread->middle_index, memory_order_relaxed);
+	const bool is_released = atomic_load_explicit(&thread->front_use_count, memory_order_acquire) == 0;
+	if ((middle & FIELD_PUBLISHED) && is_released) {
+		const int published = atomic_exchange_explicit(&thread->middle_index, thread->front_index, memory_order_acq_rel);
+		thread->front_index = published & FIELD_INDEX_MASK;
+	} else {
+		atomic_fetch_add_explicit(&thread->duplicated_field_count, 1, memory_order_relaxed);
+	}
+	atomic_fetch_add_explicit(&thread->front_use_count, 1, memory_order_relaxed);
+	return thread->front_index;
+}
+
+void racer_thread_release_field(racer_thread *thread) {
+	atomic_fetch_sub_explicit(&thread->front_use_count, 1, memory_order_release);
+}
+
+long int racer_thread_get_dropped_field_count(racer_thread *thread) {
+	return atomic_load_explicit(&thread->dropped_field_count, memory_order_relaxed);
+}
+
+long int racer_thread_get_duplicated_field_count(racer_thread *thread) {
+	return atomic_load_explicit(&thread->duplicated_field_count, memory_order_relaxed);
+}
+
+void racer_thread_set_field_rate(racer_thread *thread, double field_rate) {
+	const int64_t interval = (field_rate > 0) ? (int64_t)(1e9 / field_rate) : 0;
+	atomic_store_explicit(&thread->field_interval, interval, memory_order_relaxed);
+	atomic_store_explicit(&thread->is_pacing_reset, true, memory_order_relaxed);
+}
+
+static int compare_intervals(const void *interval, const void *other_interval) {
+	const int64_t difference = *(const int64_t *)interval - *(const int64_t *)other_interval;
+	return (difference > 0) - (difference < 0);
+}
+
+racer_thread_pacing_stats racer_thread_get_pacing_stats(racer_thread *thread) {
+	racer_thread_pacing_stats stats = {
+		.overrun_count = atomic_load_explicit(&thread->overrun_count, memory_order_relaxed)
+	};
+
+	const long total_count = atomic_load_explicit(&thread->field_interval_count, memory_order_relaxed);
+	const int count = (total_count < FIELD_INTERVAL_COUNT) ? (int)total_count : FIELD_INTERVAL_COUNT;
+	if (count == 0) {
+		return stats;
+	}
+
+	int64_t intervals[FIELD_INTERVAL_COUNT];
+	for (int index = 0; index < count; ++index) {
+		intervals[index] = atomic_load_explicit(&thread->field_intervals[index], memory_order_relaxed);
+	}
+	qsort(intervals, count, sizeof(int64_t), compare_intervals);
+
+	stats.p50_interval = (long int)intervals[count / 2];
+	stats.p99_interval = (long int)intervals[(count * 99) / 100];
+	return stats;
+}
+
+void racer_thread_set_render_mode(racer_thread *thread, racer_tia_render_mode mode) {
+	atomic_store_explicit(&thread->host_render_mode, mode, memory_order_relaxed);
+}
+
+void racer_thread_set_turbo(racer_thread *thread, int decimation) {
+	atomic_store_explicit(&thread->turbo_decimation, (decimation > 0) ? decimation : 0, memory_order_relaxed);
+	atomic_store_explicit(&thread->is_pacing_reset, true, memory_order_relaxed);
 }
@@ -9,12 +9,22 @@
 #define thread_h
 
 #include "atari2600.h"
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
 typedef struct racer_thread racer_thread;
 
-racer_thread *racer_thread_create(racer_atari2600 *console, uint8_t *buffer, size_t buffer_size);
+/// The number of video buffers, which fields are handed off through between emulation and its
+/// consumer.
+#define RACER_THREAD_BUFFER_COUNT 3
+
+/// Creates a paused emulation thread of the specified console, which draws fields into the specified
+/// video buffers of the specified size each.
+///
+/// Every completed field is published to the consumer without waiting for it; buffers are only
+/// ever read by the consumer after it acquires them.
+racer_thread *racer_thread_create(racer_atari2600 *console, uint8_t *const buffers[RACER_THREAD_BUFFER_COUNT], size_t buffer_size);
 void racer_thread_destroy(racer_thread *thread);
 
 void racer_thread_resume(racer_thread *thread);
@@ -23,4 +33,73 @@ bool racer_thread_is_paused(racer_thread *thread);
 
 long int racer_thread_get_field_time(racer_thread *thread);
 
+/// Returns smoothed time of emulating a single field, in nanoseconds, including fields, which are
+/// never published in turbo; same as field time otherwise.
+long int racer_thread_get_emulated_field_time(racer_thread *thread);
+
+/// Returns the index of the video buffer, which holds the most recently published field.
+///
+/// The buffer is never written by emulation until it is released, which may happen after the
+/// consumer is done reading it asynchronously (e.g. once GPU completes rendering). Acquiring a field
+/// again, while the previous one is still not released, returns the same buffer, as does acquiring
+/// one when no field has been published since.
+int racer_thread_acquire_field(racer_thread *thread);
+
+/// Releases the video buffer most recently acquired, letting emulation draw into it once the
+/// consumer acquires a newer field; every acquired field is to be released exactly once, from any
+/// thread.
+void racer_thread_release_field(racer_thread *thread);
+
+/// Returns the number of published fields, which were replaced by newer ones before the consumer
+/// acquired them.
+long int racer_thread_get_dropped_field_count(racer_thread *thread);
+
+/// Returns the number of times the consumer acquired a field again, since no newer one was
+/// published, or the previous one was not released yet.
+long int racer_thread_get_duplicated_field_count(racer_thread *thread);
+
+/// Field rates of NTSC and PAL TVs, in fields per second.
+#define RACER_THREAD_NTSC_FIELD_RATE 59.94
+#define RACER_THREAD_PAL_FIELD_RATE 50.0
+
+/// Paces emulation to publish fields at the specified rate (in fields per second, e.g. a multiple
+/// of NTSC or PAL field rate) against monotonic clock; 0 runs emulation as fast as possible, which
+/// is the default.
+///
+/// Emulation sleeps until shortly before each field is due, and spins for the rest, so fields are
+/// published within microseconds of their due time. A field, which completes after its due time,
+/// counts as an overrun; once emulation falls behind by more than a field, pacing restarts from
+/// the current time instead of catching up.
+void racer_thread_set_field_rate(racer_thread *thread, double field_rate);
+
+/// Statistics of intervals between recently published fields, in nanoseconds.
+typedef struct {
+	long int p50_interval;
+	long int p99_interval;
+
+	/// The number of fields, which completed after their due time, since the thread was created.
+	long int overrun_count;
+} racer_thread_pacing_stats;
+
+/// Returns statistics of intervals between the most recently published fields.
+racer_thread_pacing_stats racer_thread_get_pacing_stats(racer_thread *thread);
+
+/// Switches render mode of the TIA, which published fields are rendered in, the same as
+/// `racer_tia_set_render_mode`, but safely while emulation runs; emulation applies it once the
+/// next field starts.
+///
+/// Render mode of the TIA is selected by emulation at every field, so once the thread is created,
+/// it is only to be switched through the thread. Defaults to the one selected when the thread was
+/// created.
+void racer_thread_set_render_mode(racer_thread *thread, racer_tia_render_mode mode);
+
+/// Runs emulation as fast as possible, ignoring field rate, and publishes only one of every
+/// specified number of fields (i.e. 1 publishes every field, 2 every other one); 0 turns turbo off,
+/// which is the default.
+///
+/// Fields, which are not published, are not drawn at all; collisions are still detected in them,
+/// so emulation stays exact. Published fields are rendered in the render mode selected through the
+/// thread, the same as without turbo.
+void racer_thread_set_turbo(racer_thread *thread, int decimation);
+
 #endif /* thread_h */
@@ -7,34 +7,142 @@
 #include "tia.h"
 #include "flags.h"
 
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 
 // MARK: Object positioning
-static void advance_player_position(racer_player *player) {
-	player->position += 1;
+/**
+ * Sets position counter of the specified object to the specified value at the current position clock.
+ */
+#define set_object_position(tia, object, position) \
+(object)->start_position = (position) - (tia)->position_clock
+
+#define apply_object_motion(object) \
+(object)->start_position += (object)->motion ^ 0x8
+
+#define reset_object_motion(object) \
+(object)->motion = 0
+
+/**
+ * Schedules the next position clock, at which position counter of any object wraps around.
+ */
+static void schedule_wraps(racer_tia *tia) {
+	const int start_positions[] = {
+		tia->players[0].start_position,
+		tia->players[1].start_position,
+		tia->missiles[0].start_position,
+		tia->missiles[1].start_position,
+		tia->ball.start_position
+	};
+	tia->wrap_clock = INT_MAX;
+	for (size_t i = 0; i < sizeof(start_positions) / sizeof(start_positions[0]); ++i) {
+		// position counter wraps around on the color clock it reaches 160
+		// from 159; it never does, when it is already past 159
+		const int position = racer_tia_get_position(tia, start_positions[i]);
+		const int wrap_clock = tia->position_clock + 160 - position;
+		if (position < 160 && wrap_clock < tia->wrap_clock) {
+			tia->wrap_clock = wrap_clock;
+		}
+	}
+}
+
+/**
+ * Rebases start positions of all objects to position clock 0, so that it never overflows.
+ */
+static void rebase_positions(racer_tia *tia) {
+	const int clocks = tia->position_clock;
+	tia->players[0].start_position += clocks;
+	tia->players[1].start_position += clocks;
+	tia->missiles[0].start_position += clocks;
+	tia->missiles[1].start_position += clocks;
+	tia->ball.start_position += clocks;
 	
-	if (player->position == 160) {
-		player->position = 0;
-		// reset position counter of a missile, if it is reset to player
-		*player->missile_position = 0;
-		
-		// clear position reset flag and enable drawing main copy
-		player->control &= ~PLAYER_POSITION_RESET;
+	tia->position_clock = 0;
+	schedule_wraps(tia);
+}
+
+static void wrap_player_position(racer_tia *tia, racer_player *player) {
+	if (racer_tia_get_position(tia, player->start_position) != 160) {
+		return;
+	}
+	set_object_position(tia, player, 0);
+	
+	// reset position counter of a missile, if it is reset to player; it
+	// still advances by 1 on the same color clock
+	*player->missile_position = 1 - tia->position_clock;
+	
+	// clear position reset flag and enable drawing main copy
+	player->control &= ~PLAYER_POSITION_RESET;
+	if ((player->copy_mask & 0x1) == 0) {
 		player->copy_mask |= 0x1;
+		update_player_coverage(player);
 	}
 }
 
-#define advance_object_position(object) \
-(object)->position += 1; \
-if ((object)->position == 160) { \
-(object)->position = 0; \
+#define wrap_object_position(tia, object) \
+if (racer_tia_get_position(tia, (object)->start_position) == 160) { \
+set_object_position(tia, object, 0); \
 }
 
-#define apply_object_motion(object) \
-(object)->position += (object)->motion ^ 0x8
+/**
+ * Wraps around position counters of all objects, which reach 160 at the current position clock, and
+ * schedules the next wrap.
+ *
+ * Players wrap around first, so that missiles reset to them do not wrap on the same color clock.
+ */
+static void wrap_positions(racer_tia *tia) {
+	wrap_player_position(tia, &tia->players[0]);
+	wrap_player_position(tia, &tia->players[1]);
+	wrap_object_position(tia, &tia->missiles[0]);
+	wrap_object_position(tia, &tia->missiles[1]);
+	wrap_object_position(tia, &tia->ball);
+	schedule_wraps(tia);
+}
 
-#define reset_object_motion(object) \
-(object)->motion = 0
+/**
+ * Advances position counters of all objects by 1 color clock.
+ */
+static inline void advance_positions(racer_tia *tia) {
+	tia->position_clock += 1;
+	if (tia->position_clock == tia->wrap_clock) {
+		wrap_positions(tia);
+	}
+}
+
+/**
+ * Moves position counters of all objects by the specified number of color clocks, none of which wraps
+ * around any of them.
+ */
+static inline void move_positions(racer_tia *tia, int clocks) {
+	tia->position_clock += clocks;
+}
+
+/**
+ * Returns the number of color clocks, no more than the specified number, which position counters of
+ * all objects advance before any of them wraps around.
+ */
+static int get_wrap_clocks(const racer_tia *tia, int clocks) {
+	const int wrap_clocks = tia->wrap_clock - tia->position_clock - 1;
+	return (wrap_clocks < clocks) ? wrap_clocks : clocks;
+}
+
+/**
+ * Advances position counters of all objects by the specified number of color clocks, same as advancing
+ * them 1 color clock at a time, but only stepping through color clocks, which wrap around any of them.
+ */
+static void step_positions(racer_tia *tia, int clocks) {
+	while (clocks > 0) {
+		const int wrap_clocks = get_wrap_clocks(tia, clocks);
+		move_positions(tia, wrap_clocks);
+		clocks -= wrap_clocks;
+		
+		if (clocks > 0) {
+			advance_positions(tia);
+			clocks -= 1;
+		}
+	}
+}
 
 static uint16_t copy_modes[][2] = {
 	{0x001, 0},	// ●○○○○○○○○○
@@ -48,23 +156,112 @@ static uint16_t copy_modes[][2] = {
 };
 
 
+/**
+ * Returns the first color clock of the current scan line, which is written to video buffer in the current
+ * layout; 228 when none of them is, and `INT_MIN` when all of them are.
+ */
+static int get_output_clock(const racer_tia *tia) {
+	// every color clock is written in full layout, including those
+	// before the start of a scan line, which RSYNC sets the clock to
+	if (tia->layout.mode == TIA_LAYOUT_FULL) {
+		return INT_MIN;
+	}
+	
+	const int line = tia->line_index - tia->layout.first_line;
+	return (line >= 0 && line < tia->layout.line_count) ? 68 : 228;
+}
+
+
 // MARK: -
 void racer_tia_reset(racer_tia *tia) {
 	tia->color_clock = 0;
 	*tia->is_ready = true;
 	tia->blank_reset_clock = 68;
 	
+	// object registers are cleared before their coverage masks are built,
+	// which index tables by player scale and graphics
+	memset(tia->players, 0x00, sizeof(tia->players));
+	memset(tia->missiles, 0x00, sizeof(tia->missiles));
+	memset(&tia->ball, 0x00, sizeof(tia->ball));
+	memset(&tia->playfield, 0x00, sizeof(tia->playfield));
+	
+	update_player_coverage(&tia->players[0]);
+	update_player_coverage(&tia->players[1]);
+	update_missile_coverage(&tia->missiles[0]);
+	update_missile_coverage(&tia->missiles[1]);
+	update_ball_coverage(&tia->ball);
+	update_playfield_coverage(&tia->playfield);
+	
 	tia->output_control = 0x00;
 	tia->input_control = 0x00;
 	tia->input_latch = 0xc0;
+	tia->field_count = 0;
+	tia->line_index = 0;
+	tia->output_clock = get_output_clock(tia);
+	tia->line_buffer = tia->video_buffer;
+	
+	tia->players[0].missile_position = &tia->null_missile_position;
+	tia->players[1].missile_position = &tia->null_missile_position;
 	
-	tia->players[0].missile_position = &null_missile_position;
-	tia->players[1].missile_position = &null_missile_position;
+	tia->position_clock = 0;
+	schedule_wraps(tia);
 	
 	// TODO: send composite sync
 }
 
-void racer_tia_advance_clock(racer_tia *tia) {
+/**
+ * Returns whether scan lines of the current field reduce into observation.
+ */
+static inline bool is_observed(const racer_tia *tia) {
+	return tia->observation != NULL
+	&& tia->layout.mode == TIA_LAYOUT_VISIBLE
+	&& tia->render_mode == TIA_RENDER_FULL;
+}
+
+/**
+ * Starts the next field of video output with the specified sync.
+ */
+static void start_field(racer_tia *tia, racer_video_sync sync) {
+	if (is_observed(tia)) {
+		racer_observation_complete_field(tia->observation);
+	}
+	
+	tia->field_count += 1;
+	tia->render_mode = tia->next_render_mode;
+	tia->layout = tia->next_layout;
+	
+	tia->line_index = 0;
+	tia->output_clock = get_output_clock(tia);
+	tia->sync_video(tia->video_output, sync);
+	tia->line_buffer = tia->video_buffer;
+}
+
+/**
+ * Starts the next scan line, and the next field once the current one reaches its maximum number of
+ * scan lines in visible layout.
+ *
+ * When observed, the current scan line reduces into observation, unless it has not drawn all its
+ * visible color clocks, and video buffer is rewound to its start.
+ */
+static void start_line(racer_tia *tia) {
+	if (is_observed(tia)) {
+		if (tia->video_buffer - tia->line_buffer >= 160) {
+			const int index = tia->line_index - tia->layout.first_line;
+			racer_observation_add_line(tia->observation, index, tia->video_buffer - 160);
+		}
+		tia->video_buffer = tia->line_buffer;
+	}
+	
+	tia->line_index += 1;
+	if (tia->layout.mode == TIA_LAYOUT_VISIBLE && tia->line_index >= tia->layout.field_line_count) {
+		start_field(tia, VIDEO_BUFFER_SYNC);
+	} else {
+		tia->output_clock = get_output_clock(tia);
+		tia->line_buffer = tia->video_buffer;
+	}
+}
+
+static inline void advance_clock(racer_tia *tia) {
 	// NOTE: scan line reset check needs to happen at the beginning of
 	// a color clock cycle due to simultaneous clock simulation of
 	// the console
@@ -72,52 +269,190 @@ void racer_tia_advance_clock(racer_tia *tia) {
 		tia->color_clock = 0;
 		*tia->is_ready = true;
 		tia->blank_reset_clock = 68;
+		rebase_positions(tia);
+		start_line(tia);
 		
 		// notify video output horizontal sync started
 		tia->sync_video(tia->video_output, VIDEO_HORIZONTAL_SYNC);
 	}
 	
 	const bool horizontal_blank = tia->color_clock < tia->blank_reset_clock;
+	const bool is_output = tia->color_clock >= tia->output_clock;
 	uint8_t color = horizontal_blank;
 	
 	// position counters of movable objects do not receive clock signals
 	// during horizontal blanking/retrace; no need to re-calculate draw state
 	// and update object collisions
 	if (!horizontal_blank) {
-		const uint16_t state = get_object_draw_state(tia);
-		
-		// set output color unless TIA ouputs blank
-		const bool vertical_blank = tia->output_control & TIA_OUTPUT_VERTICAL_BLANK;
-		color |= vertical_blank;
-		
-		if (!vertical_blank) {
-			const int index = draw_indices[state];
-			color = tia->colors[index];
+		// draw state is not needed, when neither colors, nor collisions
+		// are rendered
+		if (tia->render_mode != TIA_RENDER_OFF) {
+			const uint16_t state = get_object_draw_state(tia);
+			
+			// set output color unless TIA ouputs blank
+			const bool vertical_blank = tia->output_control & TIA_OUTPUT_VERTICAL_BLANK;
+			color |= vertical_blank;
+			
+			if (!vertical_blank) {
+				const int index = draw_indices[state];
+				color = tia->colors[index];
+			}
+			
+			// update collisions
+			tia->collisions |= collisions[state >> 3];
 		}
 		
-		// update collisions
-		tia->collisions |= collisions[state >> 3];
-		
 		// advance position counters of graphics objects
-		advance_player_position(&tia->players[0]);
-		advance_player_position(&tia->players[1]);
-		advance_object_position(&tia->missiles[0]);
-		advance_object_position(&tia->missiles[1]);
-		advance_object_position(&tia->ball);
+		advance_positions(tia);
 	}
 	
 	tia->color_clock += 1;
+	if (!is_output) {
+		return;
+	}
 	
 	// sync video output when buffer is filled
 	if (tia->video_buffer == tia->video_buffer_end) {
-		tia->sync_video(tia->video_output, VIDEO_BUFFER_SYNC);
+		start_field(tia, VIDEO_BUFFER_SYNC);
 	}
 	
 	// write color output
-	*tia->video_buffer = color;
+	if (tia->render_mode == TIA_RENDER_FULL) {
+		*tia->video_buffer = color;
+	}
 	tia->video_buffer++;
 }
 
+void racer_tia_advance_clock(racer_tia *tia) {
+	advance_clock(tia);
+}
+
+void racer_tia_set_render_mode(racer_tia *tia, racer_tia_render_mode mode) {
+	tia->next_render_mode = mode;
+}
+
+void racer_tia_set_layout(racer_tia *tia, racer_tia_layout layout) {
+	tia->next_layout = layout;
+}
+
+int racer_tia_get_wsync_cycles(const racer_tia *tia) {
+	// scan line resets at the beginning of the color clock following
+	// the last one, which may fall in the middle of an MPU cycle
+	const int remaining_clocks = 228 - tia->color_clock;
+	return (remaining_clocks > 0) ? remaining_clocks / 3 : 0;
+}
+
+
+// MARK: -
+// MARK: Span drawing
+
+/**
+ * Returns whether color clocks past horizontal blanking are currently blank, i.e. neither write any
+ * colors to video buffer, nor latch any collisions, regardless of position counters of objects.
+ *
+ * Position counters of objects are advanced in bulk across blank color clocks, wrapping around as
+ * many times as needed.
+ */
+static bool is_span_blank(const racer_tia *tia) {
+	if (tia->render_mode == TIA_RENDER_OFF) {
+		return true;
+	}
+	
+	const bool vertical_blank = tia->output_control & TIA_OUTPUT_VERTICAL_BLANK;
+	const bool is_output = tia->render_mode == TIA_RENDER_FULL && !vertical_blank && tia->color_clock >= tia->output_clock;
+	return !is_output && !can_add_collisions(tia);
+}
+
+/**
+ * Returns the number of color clocks, starting at the current one and no more than the specified number,
+ * which can be drawn as a single span; 0 when the current color clock must be advanced by itself.
+ *
+ * Spans do not include color clocks, which start a scan line or sync video output, and either fall
+ * entirely within horizontal blanking, or entirely past it. They also either write to video buffer
+ * entirely, or not at all.
+ */
+static int get_span_clocks(const racer_tia *tia, int clocks) {
+	if (tia->color_clock >= 228) {
+		return 0;
+	}
+	
+	const bool is_output = tia->color_clock >= tia->output_clock;
+	int span_clocks = clocks;
+	const int limits[] = {
+		228 - tia->color_clock,
+		is_output ? (int)(tia->video_buffer_end - tia->video_buffer) : tia->output_clock - tia->color_clock
+	};
+	for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); ++i) {
+		span_clocks = (limits[i] < span_clocks) ? limits[i] : span_clocks;
+	}
+	
+	// position counters do not advance during horizontal blanking
+	if (tia->color_clock < tia->blank_reset_clock) {
+		const int blank_clocks = tia->blank_reset_clock - tia->color_clock;
+		return (blank_clocks < span_clocks) ? blank_clocks : span_clocks;
+	}
+	return span_clocks;
+}
+
+/**
+ * Draws the specified number of blank color clocks, either of horizontal blanking, or of a blank span
+ * past it, with position counters of objects advanced only in the latter.
+ */
+static void draw_blank_span(racer_tia *tia, int clocks) {
+	const bool is_output = tia->color_clock >= tia->output_clock;
+	if (is_output && tia->render_mode == TIA_RENDER_FULL) {
+		memset(tia->video_buffer, 1, clocks);
+	}
+	if (tia->color_clock >= tia->blank_reset_clock) {
+		step_positions(tia, clocks);
+	}
+	tia->video_buffer += is_output ? clocks : 0;
+	tia->color_clock += clocks;
+}
+
+/**
+ * Draws the specified number of color clocks past horizontal blanking, unless they are not written to
+ * video buffer, adds collisions during them, and advances position counters of all objects by the same
+ * number.
+ */
+static void draw_span(racer_tia *tia, int clocks) {
+	const bool is_output = tia->color_clock >= tia->output_clock;
+	if (tia->render_mode != TIA_RENDER_OFF) {
+		add_collisions(tia, clocks);
+	}
+	if (is_output && tia->render_mode == TIA_RENDER_FULL) {
+		draw_graphics(tia, clocks);
+	}
+	move_positions(tia, clocks);
+	
+	tia->video_buffer += is_output ? clocks : 0;
+	tia->color_clock += clocks;
+}
+
+void racer_tia_advance_clocks(racer_tia *tia, int cycles) {
+	while (cycles > 0) {
+		const int clocks = get_span_clocks(tia, cycles);
+		const bool horizontal_blank = tia->color_clock < tia->blank_reset_clock;
+		
+		// spans past horizontal blanking end before position counter of any
+		// object wraps around, unless they are blank
+		const int wrap_clocks = horizontal_blank ? clocks : get_wrap_clocks(tia, clocks);
+		if (clocks == 0) {
+			advance_clock(tia);
+			cycles -= 1;
+		} else if (horizontal_blank || (wrap_clocks < clocks && is_span_blank(tia))) {
+			draw_blank_span(tia, clocks);
+			cycles -= clocks;
+		} else if (wrap_clocks == 0) {
+			advance_clock(tia);
+			cycles -= 1;
+		} else {
+			draw_span(tia, wrap_clocks);
+			cycles -= wrap_clocks;
+		}
+	}
+}
+
 
 // MARK: -
 // MARK: Input port
@@ -165,7 +500,7 @@ uint8_t racer_tia_read(const racer_tia *tia, uint8_t address) {
 			const uint8_t data = (tia->collisions >> 14) & 0x3;
 			return (data << 6) | address;
 		}
-			
+		
 		case 0x08: {// MARK: inpt0
 			const uint8_t data = tia->read_port(tia->peripheral);
 			return (data << 7) & 0x80;
@@ -209,11 +544,11 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			
 			// notify video output when vertical sync started
 			if (vertical_sync) {
-				tia->sync_video(tia->video_output, VIDEO_VERTICAL_SYNC);
+				start_field(tia, VIDEO_VERTICAL_SYNC);
 			}
 			break;
 		}
-			
+		
 		case 0x01: {// MARK: vblank
 			// vertical blanking
 			const bool vertical_blank = data & 0x2;
@@ -228,7 +563,7 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			}
 			break;
 		}
-			
+		
 		case 0x02:	// MARK: wsync
 			// when the last clock cycle of WSYNC write instruction coincides
 			// with the last color clock of a scan line (which resets color
@@ -237,12 +572,17 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 				*tia->is_ready = false;
 			}
 			break;
-			
+		
 		case 0x03:	// MARK: rsync
 			// FIXME: RSYNC
 			tia->color_clock = -6;
-			break;
 			
+			// scan line restarts, and so does its output to observation
+			if (is_observed(tia)) {
+				tia->video_buffer = tia->line_buffer;
+			}
+			break;
+		
 		case 0x04: {// MARK: nusiz0
 			const uint16_t *copy_mode = copy_modes[data & 0x7];
 			tia->players[0].copy_mask = copy_mode[0];
@@ -251,6 +591,9 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			const int missile_scale = (data >> 4) & 0x3;
 			tia->missiles[0].copy_mask = copy_mode[0];
 			tia->missiles[0].size = 1 << missile_scale;
+			
+			update_player_coverage(&tia->players[0]);
+			update_missile_coverage(&tia->missiles[0]);
 			break;
 		}
 		case 0x05: {// MARK: nusiz1
@@ -261,9 +604,12 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			const int missile_scale = (data >> 4) & 0x3;
 			tia->missiles[1].copy_mask = copy_mode[0];
 			tia->missiles[1].size = 1 << missile_scale;
+			
+			update_player_coverage(&tia->players[1]);
+			update_missile_coverage(&tia->missiles[1]);
 			break;
 		}
-			
+		
 		case 0x06:	// MARK: colup0
 			tia->colors[0] = data;
 			break;
@@ -276,13 +622,15 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 		case 0x09:	// MARK: colubk
 			tia->colors[3] = data;
 			break;
-			
+		
 		case 0x0a: {// MARK: ctrlpf
 			tia->playfield.control = data & 0x3;
 			tia->ball.size = 1 << ((data >> 4) & 0x3);
+			update_ball_coverage(&tia->ball);
+			update_playfield_coverage(&tia->playfield);
 			break;
 		}
-			
+		
 		case 0x0d: {// MARK: pf0
 			const uint64_t graphics = data >> 4;
 			tia->playfield.graphics[0] &= 0xffff0ffff0;
@@ -291,6 +639,7 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			const uint64_t reflected = reflections[graphics];
 			tia->playfield.graphics[1] &= 0x0fffffff0;
 			tia->playfield.graphics[1] |= graphics | (reflected << (40-8));
+			update_playfield_coverage(&tia->playfield);
 			break;
 		}
 		case 0x0e: {// MARK: pf1
@@ -301,6 +650,7 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			const uint64_t reflected = data;
 			tia->playfield.graphics[1] &= 0xf00ffff00f;
 			tia->playfield.graphics[1] |= (graphics << 4) | (reflected << (20+8));
+			update_playfield_coverage(&tia->playfield);
 			break;
 		}
 		case 0x0f: {// MARK: pf2
@@ -311,43 +661,53 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			const uint64_t reflected = reflections[data];
 			tia->playfield.graphics[1] &= 0xfff0000fff;
 			tia->playfield.graphics[1] |= (graphics << 12) | (reflected << 20);
+			update_playfield_coverage(&tia->playfield);
 			break;
 		}
-			
+		
 		case 0x0b:	// MARK: refp0
 			set_flag(tia->players[0].control, PLAYER_REFLECTED, !(data & 0x8));
+			update_player_coverage(&tia->players[0]);
 			break;
 		case 0x0c:	// MARK: refp1
 			set_flag(tia->players[1].control, PLAYER_REFLECTED, !(data & 0x8));
+			update_player_coverage(&tia->players[1]);
 			break;
-			
+		
 		case 0x10: {// MARK: resp0
 			// it takes 4 color clock cycles to reset position counter and
 			// an extra clock cycle to latch the draw start signal
-			tia->players[0].position = 160-4-1;
+			set_object_position(tia, &tia->players[0], 160-4-1);
+			schedule_wraps(tia);
 			
 			// clear first bit in copy mask to skip drawing first player copy
 			tia->players[0].control |= PLAYER_POSITION_RESET;
 			tia->players[0].copy_mask &= ~0x1;
+			update_player_coverage(&tia->players[0]);
 			break;
 		}
 		case 0x11: {// MARK: resp1
-			tia->players[1].position = 160-4-1;
+			set_object_position(tia, &tia->players[1], 160-4-1);
+			schedule_wraps(tia);
 			tia->players[1].control |= PLAYER_POSITION_RESET;
 			tia->players[1].copy_mask &= ~0x1;
+			update_player_coverage(&tia->players[1]);
 			break;
 		}
 		case 0x12:	// MARK: resm0
 			// it takes 4 color clock cycles to reset position counter
-			tia->missiles[0].position = 160-4;
+			set_object_position(tia, &tia->missiles[0], 160-4);
+			schedule_wraps(tia);
 			break;
 		case 0x13:	// MARK: resm1
-			tia->missiles[1].position = 160-4;
+			set_object_position(tia, &tia->missiles[1], 160-4);
+			schedule_wraps(tia);
 			break;
 		case 0x14:	// MARK: resbl
-			tia->ball.position = 160-4;
+			set_object_position(tia, &tia->ball, 160-4);
+			schedule_wraps(tia);
 			break;
-			
+		
 		case 0x1b: {// MARK: grp0
 			// set player 0 graphics
 			tia->players[0].graphics[0] = data;
@@ -356,9 +716,12 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			// copy player 1 delayed graphics
 			tia->players[1].graphics[2] = tia->players[1].graphics[0];
 			tia->players[1].graphics[3] = tia->players[1].graphics[1];
+			
+			update_player_coverage(&tia->players[0]);
+			update_player_coverage(&tia->players[1]);
 			break;
 		}
-			
+		
 		case 0x1c: {// MARK: grp1
 			// set player 1 graphics
 			tia->players[1].graphics[0] = data;
@@ -371,19 +734,26 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			// copy ball delayed control flag
 			tia->ball.control &= ~BALL_ENABLED_1;
 			tia->ball.control |= (bool)(tia->ball.control & BALL_ENABLED_0);
+			
+			update_player_coverage(&tia->players[0]);
+			update_player_coverage(&tia->players[1]);
+			update_ball_coverage(&tia->ball);
 			break;
 		}
-			
+		
 		case 0x1d:	// MARK: enam0
 			set_flag(tia->missiles[0].control, MISSILE_ENABLED, data & 0x2);
+			update_missile_coverage(&tia->missiles[0]);
 			break;
 		case 0x1e:	// MARK: enam1
 			set_flag(tia->missiles[1].control, MISSILE_ENABLED, data & 0x2);
+			update_missile_coverage(&tia->missiles[1]);
 			break;
 		case 0x1f:	// MARK: enabl
 			set_flag(tia->ball.control, BALL_ENABLED_0, data & 0x2);
+			update_ball_coverage(&tia->ball);
 			break;
-			
+		
 		case 0x20:	// MARK: hmp0
 			tia->players[0].motion = data >> 4;
 			break;
@@ -399,38 +769,43 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 		case 0x24:	// MARK: hmbl
 			tia->ball.motion = data >> 4;
 			break;
-			
+		
 		case 0x25:	// MARK: vdelp0
 			set_flag(tia->players[0].control, PLAYER_DELAYED, data & 0x1);
+			update_player_coverage(&tia->players[0]);
 			break;
 		case 0x26:	// MARK: vdelp1
 			set_flag(tia->players[1].control, PLAYER_DELAYED, data & 0x1);
+			update_player_coverage(&tia->players[1]);
 			break;
 		case 0x27:	// MARK: vdelbl
 			set_flag(tia->ball.control, BALL_DELAYED, data & 0x1);
+			update_ball_coverage(&tia->ball);
 			break;
-			
+		
 		case 0x28: {// MARK: resmp0
 			if (data & 0x2) {
 				tia->missiles[0].control |= MISSILE_RESET_TO_PLAYER;
-				tia->players[0].missile_position = &tia->missiles[1].position;
+				tia->players[0].missile_position = &tia->missiles[1].start_position;
 			} else {
 				tia->missiles[0].control &= ~MISSILE_RESET_TO_PLAYER;
-				tia->players[0].missile_position = &null_missile_position;
+				tia->players[0].missile_position = &tia->null_missile_position;
 			}
+			update_missile_coverage(&tia->missiles[0]);
 			break;
 		}
 		case 0x29: {// MARK: resmp1
 			if (data & 0x2) {
 				tia->missiles[1].control |= MISSILE_RESET_TO_PLAYER;
-				tia->players[1].missile_position = &tia->missiles[1].position;
+				tia->players[1].missile_position = &tia->missiles[1].start_position;
 			} else {
 				tia->missiles[1].control &= ~MISSILE_RESET_TO_PLAYER;
-				tia->players[1].missile_position = &null_missile_position;
+				tia->players[1].missile_position = &tia->null_missile_position;
 			}
+			update_missile_coverage(&tia->missiles[1]);
 			break;
 		}
-			
+		
 		case 0x2a: {// MARK: hmove
 			tia->blank_reset_clock = 68+8;
 			
@@ -446,9 +821,10 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			apply_object_motion(&tia->missiles[0]);
 			apply_object_motion(&tia->missiles[1]);
 			apply_object_motion(&tia->ball);
+			schedule_wraps(tia);
 			break;
 		}
-			
+		
 		case 0x2b: {// MARK: hmclr
 			reset_object_motion(&tia->players[0]);
 			reset_object_motion(&tia->players[1]);
@@ -457,11 +833,11 @@ void racer_tia_write(racer_tia *tia, uint8_t address, uint8_t data) {
 			reset_object_motion(&tia->ball);
 			break;
 		}
-			
+		
 		case 0x2c:	// MARK: cxclr
 			tia->collisions = 0;
 			break;
-			
+		
 		default:
 			break;
 	}
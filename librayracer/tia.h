@@ -9,6 +9,7 @@
 #define tia_h
 
 #include "graphics.h"
+#include "observation.h"
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -19,19 +20,98 @@ typedef enum {
 	VIDEO_BUFFER_SYNC = 1<<2
 } racer_video_sync;
 
+/**
+ * Modes of rendering color clocks of the TIA.
+ */
+typedef enum {
+	/**
+	 * Colors are written to video buffer, and collisions are latched.
+	 */
+	TIA_RENDER_FULL,
+	
+	/**
+	 * Only collisions are latched; video buffer is advanced and synced the same, but none of colors are
+	 * resolved or written to it.
+	 */
+	TIA_RENDER_COLLISIONS,
+	
+	/**
+	 * Neither colors are written, nor collisions latched; cartridge code, which reads collision
+	 * registers, may run differently.
+	 */
+	TIA_RENDER_OFF
+} racer_tia_render_mode;
+
+/**
+ * Modes of laying out color values of a field in video buffer.
+ */
+typedef enum {
+	/**
+	 * All 228 color clocks of every scan line are written, including horizontal blanking; a field
+	 * ends on vertical sync, or once video buffer is filled.
+	 */
+	TIA_LAYOUT_FULL,
+	
+	/**
+	 * Only 160 visible color clocks of scan lines within a vertical window are written; a field ends
+	 * on vertical sync, or once it reaches its maximum number of scan lines.
+	 */
+	TIA_LAYOUT_VISIBLE
+} racer_tia_layout_mode;
+
+/**
+ * Layout of color values of a field in video buffer.
+ */
+typedef struct {
+	racer_tia_layout_mode mode;
+	
+	/**
+	 * Index of the first scan line of vertical window, counted from the start of a field, and
+	 * the number of its scan lines; video buffer must fit 160 color values of each one. Ignored in
+	 * full layout.
+	 */
+	int first_line;
+	int line_count;
+	
+	/**
+	 * The maximum number of scan lines of a field, which does not end on vertical sync. Ignored in
+	 * full layout.
+	 */
+	int field_line_count;
+} racer_tia_layout;
+
 struct racer_tia {
 	racer_player players[2];
 	racer_missile missiles[2];
 	racer_ball ball;
 	racer_playfield playfield;
-
+	
+	/**
+	 * Start position, which players reset, when their missiles are not reset to them; owned by every
+	 * TIA, so that TIAs running on different threads never write the same memory.
+	 */
+	int null_missile_position;
+	
 	int color_clock;
+	
+	/**
+	 * The number of color clocks, which position counters of objects advanced since the current scan
+	 * line started; position counters of objects are their start positions offset by it.
+	 */
+	int position_clock;
+	
+	/**
+	 * Position clock, at which position counter of any object wraps around next; `INT_MAX` when none
+	 * of them does.
+	 */
+	int wrap_clock;
+	
 	uint8_t colors[4];
 	uint16_t collisions;
-
+	
 	bool *is_ready;
 	int blank_reset_clock;
-
+	
 	/**
 	 * Reads data from the specified peripheral, connected to input port (pins I0-I5).
 	 *
@@ -43,7 +123,7 @@ struct racer_tia {
 	 */
 	uint8_t (*read_port)(const void *peripheral);
 	void *peripheral;
-
+	
 	/**
 	 * Peripheral input control flags.
 	 *
@@ -52,7 +132,7 @@ struct racer_tia {
 	 */
 	uint8_t input_control;
 	uint8_t input_latch;
-
+	
 	/**
 	 * Notifies video output when TIA starts vertical or horizontal sync or when video buffer is filled.
 	 *
@@ -63,10 +143,53 @@ struct racer_tia {
 	 */
 	void (*sync_video)(const void *video_output, racer_video_sync sync);
 	void *video_output;
-
+	
 	uint8_t *video_buffer;
 	uint8_t *video_buffer_end;
-
+	
+	/**
+	 * The number of vertical and buffer syncs of video output since reset.
+	 */
+	int field_count;
+	
+	/**
+	 * Render mode of the current field, and the one it switches to once the next field starts.
+	 */
+	racer_tia_render_mode render_mode;
+	racer_tia_render_mode next_render_mode;
+	
+	/**
+	 * Layout of the current field, and the one it switches to once the next field starts.
+	 */
+	racer_tia_layout layout;
+	racer_tia_layout next_layout;
+	
+	/**
+	 * The number of scan lines started since the current field started.
+	 */
+	int line_index;
+	
+	/**
+	 * The first color clock of the current scan line, which is written to video buffer; 228 when none
+	 * of them is, and `INT_MIN` when all of them are.
+	 */
+	int output_clock;
+	
+	/**
+	 * Observation, which every scan line of vertical window reduces into once it is drawn, in visible
+	 * layout and full render mode; `NULL` when there is none.
+	 *
+	 * With observation, video buffer is rewound to the start of every scan line, once it is reduced,
+	 * so that it only needs to fit a single one; its field completes before video output is notified
+	 * of vertical or buffer sync.
+	 */
+	racer_observation *observation;
+	
+	/**
+	 * Position of video buffer at the start of the current scan line.
+	 */
+	uint8_t *line_buffer;
+	
 	/**
 	 * Video output control flags.
 	 *
@@ -76,6 +199,13 @@ struct racer_tia {
 	uint8_t output_control;
 };
 
+/**
+ * Returns current value of position counter of an object with the specified start position.
+ */
+static inline int racer_tia_get_position(const racer_tia *tia, int start_position) {
+	return start_position + tia->position_clock;
+}
+
 /**
  * Resets the TIA.
  */
@@ -86,6 +216,28 @@ void racer_tia_reset(racer_tia *tia);
  */
 void racer_tia_advance_clock(racer_tia *tia);
 
+/**
+ * Advanced TIA clock by the specified number of cycles.
+ */
+void racer_tia_advance_clocks(racer_tia *tia, int cycles);
+
+/**
+ * Switches render mode of the TIA, starting with the next field (i.e. after the next vertical or buffer
+ * sync of video output), so that fields are never rendered partially.
+ */
+void racer_tia_set_render_mode(racer_tia *tia, racer_tia_render_mode mode);
+
+/**
+ * Switches layout of video buffer, starting with the next field, same as render mode.
+ */
+void racer_tia_set_layout(racer_tia *tia, racer_tia_layout layout);
+
+/**
+ * Returns the number of whole MPU cycles (3 color clocks each), which TIA completes before it starts
+ * the next scan line and releases RDY state of MPU.
+ */
+int racer_tia_get_wsync_cycles(const racer_tia *tia);
+
 #define TIA_INPUT_PORT_LATCH (1<<6)
 #define TIA_INPUT_PORT_DUMP (1<<7)
 #define TIA_OUTPUT_VERTICAL_BLANK (1<<0)
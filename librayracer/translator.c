@@ -0,0 +1,325 @@
+//
+//  translator.c
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#include "translator.h"
+#include "mcs6507_operations.h"
+
+#include <stdlib.h>
+#include <pthread.h>
+
+/// Registered translations of cartridge programs.
+static racer_translation *translations = NULL;
+static pthread_mutex_t translations_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+uint64_t racer_translator_get_checksum(racer_cartridge_type type, const uint8_t *data) {
+	// FNV-1a hash of ROM data
+	uint64_t checksum = 0xcbf29ce484222325;
+	const int size = racer_cartridge_get_size(type);
+	for (int index = 0; index < size; ++index) {
+		checksum ^= data[index];
+		checksum *= 0x100000001b3;
+	}
+	
+	return checksum;
+}
+
+void racer_translator_register(racer_translation *translation) {
+	pthread_mutex_lock(&translations_mutex);
+	translation->next = translations;
+	translations = translation;
+	pthread_mutex_unlock(&translations_mutex);
+}
+
+const racer_translation *racer_translator_find(const racer_cartridge_program *program) {
+	const uint64_t checksum = racer_translator_get_checksum(program->type, program->data);
+	pthread_mutex_lock(&translations_mutex);
+	
+	const racer_translation *translation = translations;
+	while (translation != NULL) {
+		if (translation->type == program->type && translation->checksum == checksum) {
+			break;
+		}
+		translation = translation->next;
+	}
+	
+	pthread_mutex_unlock(&translations_mutex);
+	return translation;
+}
+
+
+// MARK: -
+// MARK: Code discovery
+
+/// Code discovered in a cartridge program.
+typedef struct {
+	const racer_cartridge_program *program;
+	int bank_size;
+	int bank_switch_address;
+	
+	/// Whether a basic block starts at each program offset.
+	bool *is_block_start;
+	
+	// offsets of discovered blocks, which are yet to be followed
+	int *pending_blocks;
+	int pending_count;
+} discovery;
+
+/// Records basic block, which starts at the specified offset in the specified bank, unless already
+/// discovered or its first operation is not predecoded.
+static void discover_block(discovery *code, int bank, int offset) {
+	const int program_offset = bank + (offset & (code->bank_size - 1));
+	if (code->is_block_start[program_offset] || code->program->operations[program_offset].length == 0) {
+		return;
+	}
+	
+	code->is_block_start[program_offset] = true;
+	code->pending_blocks[code->pending_count++] = program_offset;
+}
+
+/// Records basic block, which starts at the specified offset in every bank.
+static void discover_bank_switched_block(discovery *code, int offset) {
+	for (int bank = 0; bank < code->program->size; bank += code->bank_size) {
+		discover_block(code, bank, offset);
+	}
+}
+
+/// Records basic blocks at the addresses stored in reset and break vectors of every bank.
+static void discover_vectors(discovery *code) {
+	const uint8_t *data = code->program->data;
+	for (int bank = 0; bank < code->program->size; bank += code->bank_size) {
+		for (int vector = 0xffc; vector <= 0xffe; vector += 2) {
+			const int offset = bank + (vector & (code->bank_size - 1));
+			const int address = data[offset] | (data[offset + 1] << 8);
+			if (address & 0x1000) {
+				discover_block(code, bank, address);
+			}
+		}
+	}
+}
+
+/// Follows basic block, which starts at the specified program offset, recording blocks it can continue
+/// with.
+///
+/// Targets of jumps and subroutine calls are assumed to be in the same bank; code following an
+/// operation, which accesses bank switching addresses, is assumed to continue in every bank.
+/// Targets of indirect jumps and returns are not followed.
+static void follow_block(discovery *code, int program_offset) {
+	const predecoded *operations = code->program->operations;
+	const int bank = program_offset & ~(code->bank_size - 1);
+	
+	int offset = program_offset - bank;
+	for (int index = operations[program_offset].block_length; index > 0; --index) {
+		const predecoded *operation = &operations[bank + offset];
+		const operation_format format = operation_formats[operation->code];
+		const int next_offset = offset + operation->length;
+		
+		switch (format.operation) {
+			case OPERATION_BRANCH: {
+				const int8_t branch_offset = (int8_t)operation->operand;
+				discover_block(code, bank, next_offset + branch_offset);
+				discover_block(code, bank, next_offset);
+				break;
+			}
+			case OPERATION_JSR:
+				discover_block(code, bank, next_offset);
+				// fall through
+			case OPERATION_JMP:
+				if (format.addressing == ADDRESSING_ABSOLUTE && (operation->operand & 0x1000)) {
+					discover_block(code, bank, operation->operand);
+				}
+				break;
+			default:
+				break;
+		}
+		
+		// accessing bank switching address can continue in any bank
+		const int address = operation->operand & 0xfff;
+		if (format.length == 3 && (operation->operand & 0x1000)
+			&& address >= code->bank_switch_address && address < 0xffc
+			&& next_offset < code->bank_size) {
+			discover_bank_switched_block(code, next_offset);
+		}
+		
+		// a block, which does not end with an operation changing control
+		// flow, continues with the next one
+		if (index == 1 && !racer_mcs6507_is_control_flow(operation) && next_offset < code->bank_size) {
+			discover_block(code, bank, next_offset);
+		}
+		offset = next_offset;
+	}
+}
+
+
+// MARK: -
+// MARK: Code generation
+
+/// Names of cartridge types, indexed by cartridge type.
+static const char *const type_names[] = {
+	[CARTRIDGE_ATARI_2KB] = "CARTRIDGE_ATARI_2KB",
+	[CARTRIDGE_ATARI_4KB] = "CARTRIDGE_ATARI_4KB",
+	[CARTRIDGE_ATARI_8KB] = "CARTRIDGE_ATARI_8KB",
+	[CARTRIDGE_ATARI_12KB] = "CARTRIDGE_ATARI_12KB",
+	[CARTRIDGE_ATARI_16KB] = "CARTRIDGE_ATARI_16KB",
+	[CARTRIDGE_ATARI_32KB] = "CARTRIDGE_ATARI_32KB"
+};
+
+/// Names of addressing modes, indexed by addressing mode.
+static const char *const addressing_names[] = {
+	[ADDRESSING_IMPLIED] = "ADDRESSING_IMPLIED",
+	[ADDRESSING_IMMEDIATE] = "ADDRESSING_IMMEDIATE",
+	[ADDRESSING_RELATIVE] = "ADDRESSING_RELATIVE",
+	[ADDRESSING_0_PAGE] = "ADDRESSING_0_PAGE",
+	[ADDRESSING_0_PAGE_X_INDEXED] = "ADDRESSING_0_PAGE_X_INDEXED",
+	[ADDRESSING_0_PAGE_Y_INDEXED] = "ADDRESSING_0_PAGE_Y_INDEXED",
+	[ADDRESSING_ABSOLUTE] = "ADDRESSING_ABSOLUTE",
+	[ADDRESSING_X_INDEXED] = "ADDRESSING_X_INDEXED",
+	[ADDRESSING_Y_INDEXED] = "ADDRESSING_Y_INDEXED",
+	[ADDRESSING_INDIRECT] = "ADDRESSING_INDIRECT",
+	[ADDRESSING_INDIRECT_X_INDEXED] = "ADDRESSING_INDIRECT_X_INDEXED",
+	[ADDRESSING_INDIRECT_Y_INDEXED] = "ADDRESSING_INDIRECT_Y_INDEXED"
+};
+
+/// Names of operation handlers, indexed by operation type.
+static const char *const handler_names[OPERATION_COUNT] = {
+#define HANDLER_NAME(name, NAME) [OPERATION_##NAME] = #name,
+	OPERATIONS(HANDLER_NAME)
+#undef HANDLER_NAME
+};
+
+/// Writes name of function of the basic block, which starts at the specified program offset.
+static void write_block_name(const discovery *code, int program_offset, FILE *output) {
+	const int bank = program_offset / code->bank_size;
+	const int address = 0x1000 | (program_offset & (code->bank_size - 1));
+	fprintf(output, "block_%d_%04x", bank, address);
+}
+
+/// Writes function of the basic block, which starts at the specified program offset.
+///
+/// Each operation is started, executed and followed by resolving the next one the same way as when
+/// interpreting it, except that operation formats and operands are constants and operation handlers
+/// are called directly.
+static void write_block(const discovery *code, int program_offset, FILE *output) {
+	const predecoded *operations = code->program->operations;
+	const bool is_multi_bank = code->program->size > code->bank_size;
+	const int bank = program_offset & ~(code->bank_size - 1);
+	
+	fprintf(output, "static int ");
+	write_block_name(code, program_offset, output);
+	fprintf(output, "(racer_atari2600 *console, const int *bank_index, int cycles) {\n");
+	fprintf(output, "\tracer_mcs6507 *mpu = console->mpu;\n");
+	fprintf(output, "\tif (mpu->operation.code != 0x%02x) {\n", operations[program_offset].code);
+	fprintf(output, "\t\treturn 0;\n");
+	fprintf(output, "\t}\n");
+	fprintf(output, "\t\n");
+	fprintf(output, "\tint count = 0;\n");
+	
+	// bank index is only checked after operations, which are not the last
+	// in a block of a multi-bank cartridge
+	if (!is_multi_bank || operations[program_offset].block_length == 1) {
+		fprintf(output, "\t(void)bank_index;\n");
+	}
+	
+	int offset = program_offset - bank;
+	for (int index = operations[program_offset].block_length; index > 0; --index) {
+		const predecoded *operation = &operations[bank + offset];
+		const operation_format format = operation_formats[operation->code];
+		
+		fprintf(output, "\t\n");
+		fprintf(output, "\t// $%04x: %s\n", 0x1000 | offset, handler_names[format.operation]);
+		fprintf(output, "\tif (!racer_translator_start_operation(console, cycles, &count)) {\n");
+		fprintf(output, "\t\treturn count;\n");
+		fprintf(output, "\t}\n");
+		fprintf(output, "\texecute_%s(mpu, mpu->operation.address);\n", handler_names[format.operation]);
+		offset += operation->length;
+		
+		// the last operation of a block decodes the next one from the bus
+		if (index == 1) {
+			fprintf(output, "\tracer_mcs6507_decode_operation(mpu);\n");
+			break;
+		}
+		
+		// so does an operation, after which its bank is switched out
+		if (is_multi_bank) {
+			fprintf(output, "\tif (*bank_index != %d) {\n", bank / code->bank_size);
+			fprintf(output, "\t\tracer_mcs6507_decode_operation(mpu);\n");
+			fprintf(output, "\t\treturn count;\n");
+			fprintf(output, "\t}\n");
+		}
+		
+		const predecoded *next = &operations[bank + offset];
+		const char *addressing = addressing_names[next->addressing];
+		fprintf(output, "\tresolve_operation(mpu, &(const predecoded){0x%02x, %s, %d, %d, %d, 0, 0x%04x}, %s, true);\n",
+				next->code, addressing, next->length, next->duration, next->page_cycles, next->operand, addressing);
+	}
+	
+	fprintf(output, "\t\n");
+	fprintf(output, "\treturn count;\n");
+	fprintf(output, "}\n");
+	fprintf(output, "\n");
+}
+
+int racer_translator_translate(racer_cartridge_type type, const uint8_t *data, const char *name, FILE *output) {
+	const racer_cartridge_program *program = racer_cartridge_retain_program(type, data);
+	discovery code = {
+		.program = program,
+		.bank_size = (type == CARTRIDGE_ATARI_2KB) ? 0x800 : 0x1000,
+		.bank_switch_address = racer_cartridge_get_bank_switch_address(type),
+		.is_block_start = (bool *)calloc(program->size, sizeof(bool)),
+		.pending_blocks = (int *)malloc(program->size * sizeof(int)),
+		.pending_count = 0
+	};
+	
+	// discover blocks reachable from vectors
+	discover_vectors(&code);
+	while (code.pending_count > 0) {
+		follow_block(&code, code.pending_blocks[--code.pending_count]);
+	}
+	
+	fprintf(output, "//\n");
+	fprintf(output, "//  %s.c\n", name);
+	fprintf(output, "//  Translated by rayracer-translate; do not edit.\n");
+	fprintf(output, "//\n");
+	fprintf(output, "\n");
+	fprintf(output, "#include \"translator.h\"\n");
+	fprintf(output, "#include \"mcs6507_operations.h\"\n");
+	fprintf(output, "\n");
+	
+	int block_count = 0;
+	for (int offset = 0; offset < program->size; ++offset) {
+		if (code.is_block_start[offset]) {
+			write_block(&code, offset, output);
+			block_count += 1;
+		}
+	}
+	
+	fprintf(output, "static const racer_translated_block blocks[0x%x] = {\n", program->size);
+	for (int offset = 0; offset < program->size; ++offset) {
+		if (code.is_block_start[offset]) {
+			fprintf(output, "\t[0x%04x] = ", offset);
+			write_block_name(&code, offset, output);
+			fprintf(output, ",\n");
+		}
+	}
+	fprintf(output, "};\n");
+	fprintf(output, "\n");
+	fprintf(output, "racer_translation %s_translation = {\n", name);
+	fprintf(output, "\t.type = %s,\n", type_names[type]);
+	fprintf(output, "\t.checksum = 0x%016llx,\n", (unsigned long long)racer_translator_get_checksum(type, data));
+	fprintf(output, "\t.blocks = blocks\n");
+	fprintf(output, "};\n");
+	fprintf(output, "\n");
+	fprintf(output, "__attribute__((constructor))\n");
+	fprintf(output, "static void register_translation(void) {\n");
+	fprintf(output, "\tracer_translator_register(&%s_translation);\n", name);
+	fprintf(output, "}\n");
+	
+	free(code.is_block_start);
+	free(code.pending_blocks);
+	racer_cartridge_release_program(program);
+	
+	return block_count;
+}
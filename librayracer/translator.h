@@ -0,0 +1,85 @@
+//
+//  translator.h
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#ifndef translator_h
+#define translator_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "atari2600.h"
+
+/// A basic block of cartridge code translated ahead of time into C.
+///
+/// Translated block runs operations the same as the interpreter, starting at the current MPU
+/// operation and for no longer than the specified number of cycles, and stops early when its bank is
+/// switched out (i.e. the specified bank index changes). Returns the number of advanced cycles;
+/// returns 0 when the current operation is not the one the block starts with.
+typedef int (*racer_translated_block)(racer_atari2600 *console, const int *bank_index, int cycles);
+
+/// Cartridge program translated ahead of time into C.
+typedef struct racer_translation {
+	racer_cartridge_type type;
+	uint64_t checksum;
+	
+	/// Translated basic blocks, indexed by cartridge program offset; `NULL` at offsets, where no
+	/// translated block starts.
+	const racer_translated_block *blocks;
+	
+	struct racer_translation *next;
+} racer_translation;
+
+/// Returns checksum of ROM data of a cartridge with the specified type.
+uint64_t racer_translator_get_checksum(racer_cartridge_type type, const uint8_t *data);
+
+/// Translates code of a cartridge with the specified type and ROM data into a C translation unit,
+/// and writes it to the specified output.
+///
+/// Code is discovered statically, starting at reset and break vectors of every bank and following
+/// branches, jumps and subroutine calls; every discovered basic block is translated into a function
+/// of its own. The translation unit registers itself, when linked with librayracer, under the
+/// specified name, which must be a valid C identifier.
+///
+/// Returns the number of translated basic blocks.
+int racer_translator_translate(racer_cartridge_type type, const uint8_t *data, const char *name, FILE *output);
+
+/// Registers the specified translation, so that it runs code of the cartridge it was translated from,
+/// whenever such cartridge is inserted.
+///
+/// Translation units written by `racer_translator_translate` register themselves.
+void racer_translator_register(racer_translation *translation);
+
+/// Returns registered translation of the specified cartridge program; `NULL` when there is none.
+const racer_translation *racer_translator_find(const racer_cartridge_program *program);
+
+
+// MARK: -
+// MARK: Translated code
+
+/// Starts the current MPU operation of translated code, when MPU is ready and the operation
+/// completes within the specified number of cycles.
+///
+/// Advances the specified cycle count and lags of TIA and RIOT clocks by the remaining cycles of the
+/// operation, same as the interpreter. Returns `false` when the operation cannot start.
+static inline bool racer_translator_start_operation(racer_atari2600 *console, int cycles, int *count) {
+	racer_mcs6507 *mpu = console->mpu;
+	const int remaining_cycles = mpu->operation.duration - mpu->operation_clock;
+	if (!mpu->is_ready || *count + remaining_cycles > cycles) {
+		return false;
+	}
+	
+	console->tia_lag += remaining_cycles;
+	console->riot_lag += remaining_cycles;
+	*count += remaining_cycles;
+	
+	mpu->program_counter += mpu->operation.length;
+	mpu->operation_clock = 0;
+	return true;
+}
+
+#endif /* translator_h */
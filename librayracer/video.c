@@ -0,0 +1,195 @@
+//
+//  video.c
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#include "video.h"
+#include "palette.h"
+
+#include <string.h>
+
+// AVX2 conversion is compiled on x86-64 regardless of target flags, and
+// selected at run time on processors, which support it
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define VIDEO_AVX2 __attribute__((target("avx2")))
+#endif
+
+// MARK: Palette
+
+#define RGBA_COLOR(r, g, b) {r, g, b, 0xff},
+#define BGRA_COLOR(r, g, b) {b, g, r, 0xff},
+#define RGB565_COLOR(r, g, b) (uint16_t)(((r) >> 3) << 11 | ((g) >> 2) << 5 | (b) >> 3),
+#define GRAY_COLOR(r, g, b) (uint8_t)((77 * (r) + 150 * (g) + 29 * (b) + 128) >> 8),
+
+/// Conversion tables of all formats, indexed by palette color (i.e. TIA color value shifted right by
+/// 1, since its least significant bit is ignored and set at blank color clocks). RGB565 table has an
+/// extra entry, since its words are gathered 2 at a time.
+static const uint8_t rgba_colors[0x80][4] = {NTSC_PALETTE(RGBA_COLOR)};
+static const uint8_t bgra_colors[0x80][4] = {NTSC_PALETTE(BGRA_COLOR)};
+static const uint16_t rgb565_colors[0x80 + 1] = {NTSC_PALETTE(RGB565_COLOR)};
+static const uint8_t gray_colors[0x80] = {NTSC_PALETTE(GRAY_COLOR)};
+
+
+// MARK: -
+// MARK: Conversion
+
+/// Converts the specified number of color values into 4-byte pixels of the specified conversion table.
+static inline void convert_words(const uint8_t *colors, int count, const uint8_t table[0x80][4], uint8_t *pixels) {
+	for (int index = 0; index < count; ++index) {
+		memcpy(pixels + index * 4, table[colors[index] >> 1], 4);
+	}
+}
+
+static void convert_rgba(const uint8_t *colors, int count, void *pixels) {
+	convert_words(colors, count, rgba_colors, pixels);
+}
+
+static void convert_bgra(const uint8_t *colors, int count, void *pixels) {
+	convert_words(colors, count, bgra_colors, pixels);
+}
+
+static void convert_rgb565(const uint8_t *colors, int count, void *pixels) {
+	uint16_t *words = pixels;
+	for (int index = 0; index < count; ++index) {
+		words[index] = rgb565_colors[colors[index] >> 1];
+	}
+}
+
+static void convert_gray(const uint8_t *colors, int count, void *pixels) {
+	uint8_t *bytes = pixels;
+	for (int index = 0; index < count; ++index) {
+		bytes[index] = gray_colors[colors[index] >> 1];
+	}
+}
+
+
+// MARK: -
+// MARK: AVX2 conversion
+#if defined(VIDEO_AVX2)
+
+/// Looks up bytes of a 128-byte table at the specified 7-bit indices, a shuffle of its 16-byte chunk at
+/// a time.
+///
+/// Indices are offset by 16 for every next chunk, so that its shuffle zeroes lanes of preceding chunks
+/// (which get bit 7 set), and yields entries at the same offset for lanes of the current and following
+/// chunks; every chunk is shuffled XOR-ed with the previous one, so that those cancel out.
+VIDEO_AVX2 static inline __m256i shuffle_bytes(__m256i indices, const uint8_t table[0x80]) {
+	__m256i bytes = _mm256_setzero_si256();
+	__m256i previous = _mm256_setzero_si256();
+	for (int chunk = 0; chunk < 8; ++chunk) {
+		const __m256i entries = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(table + chunk * 16)));
+		const __m256i offset_indices = _mm256_sub_epi8(indices, _mm256_set1_epi8(chunk * 16));
+		bytes = _mm256_xor_si256(bytes, _mm256_shuffle_epi8(_mm256_xor_si256(entries, previous), offset_indices));
+		previous = entries;
+	}
+	return bytes;
+}
+
+/// Same as `convert_words`, but pixels of 8 color values are gathered from the table at once.
+VIDEO_AVX2 static inline void convert_avx2_words(const uint8_t *colors, int count, const uint8_t table[0x80][4], uint8_t *pixels) {
+	int index = 0;
+	for (; index + 8 <= count; index += 8) {
+		const __m256i values = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(colors + index)));
+		const __m256i words = _mm256_i32gather_epi32((const int *)table, _mm256_srli_epi32(values, 1), 4);
+		_mm256_storeu_si256((__m256i *)(pixels + index * 4), words);
+	}
+	convert_words(colors + index, count - index, table, pixels + index * 4);
+}
+
+VIDEO_AVX2 static void convert_avx2_rgba(const uint8_t *colors, int count, void *pixels) {
+	convert_avx2_words(colors, count, rgba_colors, pixels);
+}
+
+VIDEO_AVX2 static void convert_avx2_bgra(const uint8_t *colors, int count, void *pixels) {
+	convert_avx2_words(colors, count, bgra_colors, pixels);
+}
+
+/// Pixels of 16 color values are gathered from the conversion table at once, 8 words at a time, and
+/// packed.
+VIDEO_AVX2 static void convert_avx2_rgb565(const uint8_t *colors, int count, void *pixels) {
+	uint16_t *words = pixels;
+	int index = 0;
+	for (; index + 16 <= count; index += 16) {
+		const __m256i values = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(colors + index)));
+		const __m256i indices = _mm256_srli_epi16(values, 1);
+		
+		// gathered words include the following entry in their high half
+		const __m256i mask = _mm256_set1_epi32(0xffff);
+		const __m256i first = _mm256_and_si256(mask, _mm256_i32gather_epi32((const int *)rgb565_colors, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(indices)), 2));
+		const __m256i second = _mm256_and_si256(mask, _mm256_i32gather_epi32((const int *)rgb565_colors, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(indices, 1)), 2));
+		
+		// packing interleaves 128-bit lanes
+		const __m256i packed = _mm256_packus_epi32(first, second);
+		_mm256_storeu_si256((__m256i *)(words + index), _mm256_permute4x64_epi64(packed, 0xd8));
+	}
+	convert_rgb565(colors + index, count - index, words + index);
+}
+
+/// Pixels of 32 color values are shuffled from the conversion table at once.
+VIDEO_AVX2 static void convert_avx2_gray(const uint8_t *colors, int count, void *pixels) {
+	uint8_t *bytes = pixels;
+	int index = 0;
+	for (; index + 32 <= count; index += 32) {
+		const __m256i values = _mm256_loadu_si256((const __m256i *)(colors + index));
+		const __m256i indices = _mm256_and_si256(_mm256_srli_epi16(values, 1), _mm256_set1_epi8(0x7f));
+		_mm256_storeu_si256((__m256i *)(bytes + index), shuffle_bytes(indices, gray_colors));
+	}
+	convert_gray(colors + index, count - index, bytes + index);
+}
+#endif
+
+
+// MARK: -
+/// A handler, which converts a row of the specified number of color values into pixels.
+typedef void (*row_conversion)(const uint8_t *colors, int count, void *pixels);
+
+/// Row conversion handlers and pixel sizes of all formats, indexed by format; AVX2 handlers are `NULL`
+/// on architectures other than x86-64.
+static const struct {
+	row_conversion convert;
+	row_conversion convert_avx2;
+	int pixel_size;
+} formats[] = {
+#if defined(VIDEO_AVX2)
+	[VIDEO_FORMAT_RGBA8] = {convert_rgba, convert_avx2_rgba, 4},
+	[VIDEO_FORMAT_BGRA8] = {convert_bgra, convert_avx2_bgra, 4},
+	[VIDEO_FORMAT_RGB565] = {convert_rgb565, convert_avx2_rgb565, 2},
+	[VIDEO_FORMAT_GRAY8] = {convert_gray, convert_avx2_gray, 1}
+#else
+	[VIDEO_FORMAT_RGBA8] = {convert_rgba, NULL, 4},
+	[VIDEO_FORMAT_BGRA8] = {convert_bgra, NULL, 4},
+	[VIDEO_FORMAT_RGB565] = {convert_rgb565, NULL, 2},
+	[VIDEO_FORMAT_GRAY8] = {convert_gray, NULL, 1}
+#endif
+};
+
+/// Returns row conversion handler of the specified format, which uses AVX2 when the processor
+/// supports it.
+static row_conversion get_row_conversion(racer_video_format format) {
+#if defined(VIDEO_AVX2)
+	if (__builtin_cpu_supports("avx2")) {
+		return formats[format].convert_avx2;
+	}
+#endif
+	return formats[format].convert;
+}
+
+int racer_video_get_pixel_size(racer_video_format format) {
+	return formats[format].pixel_size;
+}
+
+void racer_video_convert(const uint8_t *field, int width, int height, const racer_video_rect *crop, racer_video_format format, void *pixels, size_t row_size) {
+	const racer_video_rect rect = (crop != NULL) ? *crop : (racer_video_rect){0, 0, width, height};
+	const uint8_t *colors = field + rect.y * width + rect.x;
+	uint8_t *row = pixels;
+	
+	const row_conversion convert = get_row_conversion(format);
+	for (int y = 0; y < rect.height; ++y) {
+		convert(colors, rect.width, row);
+		colors += width;
+		row += row_size;
+	}
+}
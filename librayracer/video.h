@@ -0,0 +1,53 @@
+//
+//  video.h
+//  librayracer
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#ifndef video_h
+#define video_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Pixel formats, which fields of TIA color values convert into.
+typedef enum {
+	/// 4 bytes per pixel: red, green, blue and opaque alpha, in memory order.
+	VIDEO_FORMAT_RGBA8,
+	
+	/// 4 bytes per pixel: blue, green, red and opaque alpha, in memory order.
+	VIDEO_FORMAT_BGRA8,
+	
+	/// 2 bytes per pixel: a native-endian 16-bit word of 5-bit red, 6-bit green and 5-bit blue, from
+	/// the most significant bits.
+	VIDEO_FORMAT_RGB565,
+	
+	/// 1 byte per pixel: luma of the color (BT.601).
+	VIDEO_FORMAT_GRAY8
+} racer_video_format;
+
+/// A rectangle of color clocks in a field, with origin at its top left color clock.
+typedef struct {
+	int x;
+	int y;
+	int width;
+	int height;
+} racer_video_rect;
+
+/// Returns the number of bytes of a single pixel in the specified format.
+int racer_video_get_pixel_size(racer_video_format format);
+
+/// Converts TIA color values of a field with the specified width and height (in color clocks) into
+/// pixels of the specified format, through NTSC palette.
+///
+/// Only color clocks within the specified crop rectangle are converted, or all of them when it is
+/// `NULL`; the rectangle must lie within the field. Pixels are written directly to the specified
+/// buffer, a row of the converted rectangle every specified number of bytes, which must be at least
+/// the width of the rectangle times the pixel size.
+///
+/// On x86-64, rows are converted with AVX2 whenever the processor supports it, regardless of compiler
+/// flags. On other architectures (including ARM) every pixel is a scalar table lookup.
+void racer_video_convert(const uint8_t *field, int width, int height, const racer_video_rect *crop, racer_video_format format, void *pixels, size_t row_size);
+
+#endif /* video_h */
@@ -0,0 +1,239 @@
+//
+//  main.c
+//  rayracer-bench
+//
+//  Created by Serge Tsyba on 16.10.2026.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "atari2600.h"
+
+/// The number of times every benchmark runs; the fastest run is reported.
+#define RUN_COUNT 5
+
+/// The number of fields run by render mode benchmark.
+#define FIELD_COUNT 600
+
+/// The size of video buffer of benchmarked consoles: a field of 320 scan lines of 228 color clocks.
+#define VIDEO_BUFFER_SIZE (228 * 320)
+
+/// Returns current time of monotonic clock in seconds.
+static double get_time(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/// Returns type of a cartridge with the specified ROM size; -1 when no cartridge type has such size.
+static int get_cartridge_type(long size) {
+	switch (size) {
+		case 0x800:
+			return CARTRIDGE_ATARI_2KB;
+		case 0x1000:
+			return CARTRIDGE_ATARI_4KB;
+		case 0x2000:
+			return CARTRIDGE_ATARI_8KB;
+		case 0x3000:
+			return CARTRIDGE_ATARI_12KB;
+		case 0x4000:
+			return CARTRIDGE_ATARI_16KB;
+		case 0x8000:
+			return CARTRIDGE_ATARI_32KB;
+		default:
+			return -1;
+	}
+}
+
+
+// MARK: -
+// MARK: MPU benchmark
+
+/// Flat bus of MPU benchmark: RAM below cartridge ROM, with no TIA or RIOT, and the last 4KB bank of
+/// cartridge ROM (or its only 2KB bank, mirrored) predecoded above it.
+typedef struct {
+	uint8_t memory[0x1000];
+	const racer_cartridge_program *program;
+} flat_bus;
+
+/// Returns offset in cartridge ROM of the specified address of flat bus.
+static int get_rom_offset(const flat_bus *bus, int address) {
+	const int bank_size = (bus->program->size < 0x1000) ? bus->program->size : 0x1000;
+	return bus->program->size - bank_size + (address & (bank_size - 1));
+}
+
+static uint8_t read_flat_bus(void *bus, int address) {
+	flat_bus *flat = (flat_bus *)bus;
+	return (address & 0x1000)
+	? flat->program->data[get_rom_offset(flat, address)]
+	: flat->memory[address & 0xfff];
+}
+
+static void write_flat_bus(void *bus, int address, uint8_t data) {
+	flat_bus *flat = (flat_bus *)bus;
+	if ((address & 0x1000) == 0) {
+		flat->memory[address & 0xfff] = data;
+	}
+}
+
+static const predecoded *read_flat_predecoded(void *bus, int address) {
+	const flat_bus *flat = (flat_bus *)bus;
+	if ((address & 0x1000) == 0) {
+		return NULL;
+	}
+
+	const predecoded *operation = &flat->program->operations[get_rom_offset(flat, address)];
+	return (operation->length > 0) ? operation : NULL;
+}
+
+/// Runs the specified number of MPU operations of the specified cartridge on a flat bus, so that
+/// neither TIA nor RIOT take any of the time, and returns operations per second of the fastest run.
+///
+/// Operations are dispatched through a switch over operation type, when specified, same as before
+/// they were dispatched through a handler table; otherwise, the same as the interpreter does.
+static double run_operations(flat_bus *bus, long operation_count, bool is_switched) {
+	double best_time = 0.0;
+	for (int run = 0; run < RUN_COUNT; ++run) {
+		racer_mcs6507 mpu;
+		memset(&mpu, 0x00, sizeof(mpu));
+		mpu.bus = bus;
+		mpu.read_bus = read_flat_bus;
+		mpu.write_bus = write_flat_bus;
+		mpu.read_predecoded = read_flat_predecoded;
+		mpu.is_ready = true;
+		racer_mcs6507_reset(&mpu);
+
+		const double start_time = get_time();
+		if (is_switched) {
+			for (long operation = 0; operation < operation_count; ++operation) {
+				racer_mcs6507_complete_switched_operation(&mpu);
+			}
+		} else {
+			for (long operation = 0; operation < operation_count; ++operation) {
+				racer_mcs6507_complete_operation(&mpu);
+			}
+		}
+
+		const double time = get_time() - start_time;
+		best_time = (run == 0 || time < best_time) ? time : best_time;
+	}
+
+	return operation_count / best_time;
+}
+
+/// Runs the specified number of MPU operations of the specified cartridge with both ways of
+/// dispatching operations, and reports operations per second of each one, and speedup of handler
+/// table dispatch over switch dispatch.
+static void benchmark_mpu(racer_cartridge_type type, const uint8_t *data, long operation_count) {
+	flat_bus bus;
+	memset(bus.memory, 0x00, sizeof(bus.memory));
+	bus.program = racer_cartridge_retain_program(type, data);
+
+	const double switch_rate = run_operations(&bus, operation_count, true);
+	const double table_rate = run_operations(&bus, operation_count, false);
+	racer_cartridge_release_program(bus.program);
+
+	printf("mpu switch: %ld operations, %.1f M operations/s\n", operation_count, switch_rate * 1e-6);
+	printf("mpu table: %ld operations, %.1f M operations/s, %.2fx\n", operation_count, table_rate * 1e-6, table_rate / switch_rate);
+}
+
+// MARK: -
+// MARK: Render mode benchmark
+
+static uint8_t video_buffer[VIDEO_BUFFER_SIZE];
+
+static void sync_video(const void *output, racer_video_sync sync) {
+	// restart video buffer with every field
+	racer_tia *tia = (racer_tia *)output;
+	if (sync & (VIDEO_VERTICAL_SYNC | VIDEO_BUFFER_SYNC)) {
+		tia->video_buffer = video_buffer;
+		tia->video_buffer_end = video_buffer + VIDEO_BUFFER_SIZE;
+	}
+}
+
+/// Runs the specified number of fields of the specified cartridge in the specified render mode, and
+/// returns fields per second.
+static double run_fields(racer_cartridge_type type, const uint8_t *data, racer_tia_render_mode mode, int field_count) {
+	racer_atari2600 *console = racer_atari2600_create();
+	racer_atari2600_insert_cartridge(console, type, data);
+	console->tia->video_output = console->tia;
+	console->tia->sync_video = sync_video;
+	console->tia->video_buffer = video_buffer;
+	console->tia->video_buffer_end = video_buffer + VIDEO_BUFFER_SIZE;
+	racer_atari2600_reset(console);
+
+	// render mode switches once the first field ends
+	racer_tia_set_render_mode(console->tia, mode);
+	racer_atari2600_run_frame(console);
+
+	const double start_time = get_time();
+	for (int field = 0; field < field_count; ++field) {
+		racer_atari2600_run_frame(console);
+	}
+
+	const double time = get_time() - start_time;
+	racer_atari2600_destroy(console);
+	return field_count / time;
+}
+
+/// Runs the specified number of fields of the specified cartridge in every render mode, and reports
+/// fields per second of each one, and its speedup over full rendering.
+static void benchmark_render_modes(racer_cartridge_type type, const uint8_t *data, int field_count) {
+	const struct {
+		const char *name;
+		racer_tia_render_mode mode;
+	} modes[] = {
+		{"full", TIA_RENDER_FULL},
+		{"collisions", TIA_RENDER_COLLISIONS},
+		{"off", TIA_RENDER_OFF}
+	};
+
+	double full_rate = 0.0;
+	for (size_t index = 0; index < sizeof(modes) / sizeof(modes[0]); ++index) {
+		double best_rate = 0.0;
+		for (int run = 0; run < RUN_COUNT; ++run) {
+			const double rate = run_fields(type, data, modes[index].mode, field_count);
+			best_rate = (rate > best_rate) ? rate : best_rate;
+		}
+
+		full_rate = (index == 0) ? best_rate : full_rate;
+		printf("render %s: %d fields, %.1f fields/s, %.2fx\n", modes[index].name, field_count, best_rate, best_rate / full_rate);
+	}
+}
+
+
+// MARK: -
+
+/// Benchmarks emulation of a cartridge ROM.
+///
+/// Usage: rayracer-bench <rom> [<operations>]
+int main(int argc, const char *argv[]) {
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <rom> [<operations>]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FILE *input = fopen(argv[1], "rb");
+	if (input == NULL) {
+		fprintf(stderr, "%s: cannot open ROM: %s\n", argv[0], argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	uint8_t data[0x8000 + 1];
+	const long size = fread(data, 1, sizeof(data), input);
+	fclose(input);
+
+	const int type = get_cartridge_type(size);
+	if (type < 0) {
+		fprintf(stderr, "%s: unsupported ROM size: %ld\n", argv[0], size);
+		return EXIT_FAILURE;
+	}
+
+	const long operation_count = (argc > 2) ? atol(argv[2]) : 50000000;
+	benchmark_mpu(type, data, operation_count);
+	benchmark_render_modes(type, data, FIELD_COUNT);
+	return EXIT_SUCCESS;
+}
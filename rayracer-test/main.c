@@ -0,0 +1,615 @@
+//
+//  main.c
+//  rayracer-test
+//
+//  Created by Serge Tsyba on 16.10.2026.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atari2600.h"
+#include "batch.h"
+#include "graphics.h"
+
+/// The size of video buffer of tested consoles: a field of 320 scan lines of 160 color clocks.
+#define VIDEO_BUFFER_SIZE (160 * 320)
+
+/// A test case, which returns whether it passes.
+typedef struct {
+	const char *name;
+	bool (*run)(void);
+} test_case;
+
+static uint8_t video_buffer[VIDEO_BUFFER_SIZE];
+static uint8_t stepped_video_buffer[VIDEO_BUFFER_SIZE];
+
+static void sync_video(const void *output, racer_video_sync sync) {
+	// restart video buffer with every field
+	racer_tia *tia = (racer_tia *)output;
+	if (sync & (VIDEO_VERTICAL_SYNC | VIDEO_BUFFER_SYNC)) {
+		tia->video_buffer = tia->video_buffer_end - VIDEO_BUFFER_SIZE;
+	}
+}
+
+static void set_video_buffer(racer_atari2600 *console, uint8_t *buffer) {
+	memset(buffer, 0, VIDEO_BUFFER_SIZE);
+	console->tia->video_output = console->tia;
+	console->tia->sync_video = sync_video;
+	console->tia->video_buffer = buffer;
+	console->tia->video_buffer_end = buffer + VIDEO_BUFFER_SIZE;
+}
+
+/// Fills the specified 4KB of ROM with NOP, except for the specified code at its start, and points
+/// reset vector to the code.
+static void fill_program(uint8_t *data, const uint8_t *code, int size) {
+	memset(data, 0xea, 0x1000);
+	memcpy(data, code, size);
+	data[0xffc] = 0x00;
+	data[0xffd] = 0xf0;
+}
+
+/// Creates console with a cartridge of the specified type and data.
+static racer_atari2600 *create_cartridge_console(racer_cartridge_type type, const uint8_t *data, racer_atari2600_engine engine) {
+	racer_atari2600 *console = racer_atari2600_create();
+	racer_atari2600_insert_cartridge(console, type, data);
+	racer_atari2600_set_engine(console, engine);
+	set_video_buffer(console, video_buffer);
+	racer_atari2600_reset(console);
+	return console;
+}
+
+/// Creates console with a 4KB cartridge, which runs the specified code from its start.
+static racer_atari2600 *create_console(const uint8_t *code, int size, racer_atari2600_engine engine) {
+	uint8_t data[0x1000];
+	fill_program(data, code, size);
+	return create_cartridge_console(CARTRIDGE_ATARI_4KB, data, engine);
+}
+
+/// Returns whether graphics objects and clocks of the specified TIAs are in the same state.
+static bool is_same_tia(const racer_tia *tia, const racer_tia *other) {
+	for (int index = 0; index < 2; ++index) {
+		const racer_player *player = &tia->players[index];
+		const racer_player *other_player = &other->players[index];
+		if (memcmp(player->graphics, other_player->graphics, sizeof(player->graphics)) != 0
+			|| player->control != other_player->control
+			|| player->start_position != other_player->start_position
+			|| player->motion != other_player->motion) {
+			return false;
+		}
+
+		const racer_missile *missile = &tia->missiles[index];
+		const racer_missile *other_missile = &other->missiles[index];
+		if (missile->control != other_missile->control
+			|| missile->start_position != other_missile->start_position
+			|| missile->motion != other_missile->motion) {
+			return false;
+		}
+	}
+
+	if (tia->ball.control != other->ball.control
+		|| tia->ball.start_position != other->ball.start_position
+		|| tia->ball.motion != other->ball.motion
+		|| memcmp(tia->playfield.graphics, other->playfield.graphics, sizeof(tia->playfield.graphics)) != 0
+		|| tia->playfield.control != other->playfield.control) {
+		return false;
+	}
+
+	return tia->color_clock == other->color_clock
+	&& tia->position_clock == other->position_clock
+	&& memcmp(tia->colors, other->colors, sizeof(tia->colors)) == 0
+	&& tia->collisions == other->collisions
+	&& tia->field_count == other->field_count;
+}
+
+/// Returns whether MPU, RIOT and TIA of the specified consoles are in the same state.
+static bool is_same_state(const racer_atari2600 *console, const racer_atari2600 *other) {
+	const racer_mcs6507 *mpu = console->mpu;
+	const racer_mcs6507 *other_mpu = other->mpu;
+	if (mpu->accumulator != other_mpu->accumulator
+		|| mpu->x != other_mpu->x
+		|| mpu->y != other_mpu->y
+		|| racer_mcs6507_get_status(mpu) != racer_mcs6507_get_status(other_mpu)
+		|| mpu->stack_pointer != other_mpu->stack_pointer
+		|| mpu->program_counter != other_mpu->program_counter
+		|| mpu->operation_clock != other_mpu->operation_clock
+		|| mpu->is_ready != other_mpu->is_ready) {
+		return false;
+	}
+
+	const racer_mcs6532 *riot = console->riot;
+	const racer_mcs6532 *other_riot = other->riot;
+	if (riot->timer != other_riot->timer
+		|| riot->timer_scale != other_riot->timer_scale
+		|| riot->interrupt != other_riot->interrupt
+		|| memcmp(riot->memory, other_riot->memory, sizeof(riot->memory)) != 0) {
+		return false;
+	}
+
+	return is_same_tia(console->tia, other->tia);
+}
+
+/// Copies MPU registers, RIOT timer and RAM, and TIA colors and collisions of the specified console,
+/// which are undefined at power on, to the other one, so that both consoles start from the same ones.
+static void copy_power_on_state(const racer_atari2600 *console, racer_atari2600 *other) {
+	racer_mcs6507 mpu = *console->mpu;
+	mpu.bus = other;
+	*other->mpu = mpu;
+	other->riot->timer = console->riot->timer;
+	other->riot->interrupt = console->riot->interrupt;
+	memcpy(other->riot->memory, console->riot->memory, sizeof(other->riot->memory));
+	memcpy(other->tia->colors, console->tia->colors, sizeof(other->tia->colors));
+	other->tia->collisions = console->tia->collisions;
+}
+
+/// Runs the specified cartridge on two consoles with the specified engine, one advanced a cycle at a
+/// time and the other by the specified number of cycles at a time, and verifies they are in the same
+/// state, and have drawn the same video buffer, after every step.
+static bool is_same_stepped(racer_cartridge_type type, const uint8_t *data, racer_atari2600_engine engine, int step, int step_count) {
+	racer_atari2600 *console = create_cartridge_console(type, data, engine);
+	racer_atari2600 *stepped = create_cartridge_console(type, data, engine);
+	set_video_buffer(stepped, stepped_video_buffer);
+	copy_power_on_state(console, stepped);
+
+	bool is_passed = true;
+	for (int index = 0; index < step_count && is_passed; ++index) {
+		for (int cycle = 0; cycle < step; ++cycle) {
+			racer_atari2600_advance_clock(console);
+		}
+		is_passed &= racer_atari2600_run_cycles(stepped, step) == step;
+		is_passed &= is_same_state(console, stepped);
+		is_passed &= memcmp(video_buffer, stepped_video_buffer, VIDEO_BUFFER_SIZE) == 0;
+		is_passed &= console->tia->video_buffer - video_buffer == stepped->tia->video_buffer - stepped_video_buffer;
+	}
+
+	racer_atari2600_destroy(console);
+	racer_atari2600_destroy(stepped);
+	return is_passed;
+}
+
+// MARK: -
+// MARK: Polling loops
+
+/// Polls RIOT timer forever, once it stops counting down, and verifies every field still ends with
+/// a filled video buffer.
+static bool test_stopped_timer(void) {
+	const uint8_t code[] = {
+		0xa9, 0x00,			// $f000: LDA #0
+		0x8d, 0x94, 0x02,	// $f002: STA TIM1T
+		0xa2, 0xff,			// $f005: LDX #$ff
+		0xca,				// $f007: DEX
+		0xd0, 0xfd,			// $f008: BNE $f007
+		0xad, 0x84, 0x02,	// $f00a: LDA INTIM
+		0xd0, 0xfb			// $f00d: BNE $f00a
+	};
+
+	const racer_atari2600_engine engines[] = {
+		ATARI2600_ENGINE_INTERPRETER,
+		ATARI2600_ENGINE_RECOMPILER,
+		ATARI2600_ENGINE_DIFFERENTIAL
+	};
+
+	bool is_passed = true;
+	for (size_t index = 0; index < sizeof(engines) / sizeof(engines[0]); ++index) {
+		racer_atari2600 *console = create_console(code, sizeof(code), engines[index]);
+
+		// timer stops within the delay loop, before polling starts
+		for (int field = 0; field < 4; ++field) {
+			const int field_count = console->tia->field_count;
+			const int cycles = racer_atari2600_run_frame(console);
+
+			is_passed &= console->tia->field_count == field_count + 1;
+			is_passed &= cycles > 0 && cycles <= VIDEO_BUFFER_SIZE;
+		}
+
+		is_passed &= console->mpu->program_counter >= 0xf00a && console->mpu->program_counter < 0xf00f;
+		racer_atari2600_destroy(console);
+	}
+
+	return is_passed;
+}
+
+
+// MARK: -
+// MARK: Bulk execution
+
+/// Runs a frame kernel, which syncs to scan lines, positions and moves objects, polls RIOT timer and
+/// switches banks, and verifies running cycles in bulk by odd steps is the same as advancing a cycle
+/// at a time.
+static bool test_stepped_kernel(void) {
+	const uint8_t code[] = {
+		0xa9, 0x02,			// $f000: LDA #2
+		0x85, 0x00,			// $f002: STA VSYNC
+		0x85, 0x02,			// $f004: STA WSYNC
+		0x85, 0x02,			// $f006: STA WSYNC
+		0x85, 0x02,			// $f008: STA WSYNC
+		0xa9, 0x00,			// $f00a: LDA #0
+		0x85, 0x00,			// $f00c: STA VSYNC
+		0xa9, 0x20,			// $f00e: LDA #$20
+		0x8d, 0x96, 0x02,	// $f010: STA TIM64T
+		0xa9, 0x1e,			// $f013: LDA #$1e
+		0x85, 0x06,			// $f015: STA COLUP0
+		0xa9, 0x44,			// $f017: LDA #$44
+		0x85, 0x07,			// $f019: STA COLUP1
+		0xa9, 0xf2,			// $f01b: LDA #$f2
+		0x85, 0x1b,			// $f01d: STA GRP0
+		0x85, 0x1c,			// $f01f: STA GRP1
+		0x85, 0x0e,			// $f021: STA PF1
+		0x85, 0x1d,			// $f023: STA ENAM0
+		0x85, 0x1f,			// $f025: STA ENABL
+		0xad, 0x84, 0x02,	// $f027: LDA INTIM
+		0xd0, 0xfb,			// $f02a: BNE $f027
+		0xa2, 0x64,			// $f02c: LDX #100
+		0x85, 0x02,			// $f02e: STA WSYNC
+		0x85, 0x2a,			// $f030: STA HMOVE
+		0x8a,				// $f032: TXA
+		0x85, 0x20,			// $f033: STA HMP0
+		0x85, 0x22,			// $f035: STA HMM0
+		0x85, 0x09,			// $f037: STA COLUBK
+		0x85, 0x11,			// $f039: STA RESP1
+		0xca,				// $f03b: DEX
+		0xd0, 0xf0,			// $f03c: BNE $f02e
+		0x8d, 0xf9, 0xff,	// $f03e: STA $fff9
+		0x4c, 0x00, 0xf0	// $f041: JMP $f000
+	};
+	const uint8_t switched_code[] = {
+		0x8d, 0xf8, 0xff,	// $f03e: STA $fff8
+		0xa2, 0x32,			// $f041: LDX #50
+		0x85, 0x02,			// $f043: STA WSYNC
+		0x85, 0x14,			// $f045: STA RESBL
+		0x85, 0x2a,			// $f047: STA HMOVE
+		0x8a,				// $f049: TXA
+		0x0a,				// $f04a: ASL
+		0x85, 0x21,			// $f04b: STA HMP1
+		0x85, 0x13,			// $f04d: STA RESM1
+		0x85, 0x10,			// $f04f: STA RESP0
+		0x85, 0x24,			// $f051: STA HMBL
+		0xca,				// $f053: DEX
+		0xd0, 0xed,			// $f054: BNE $f043
+		0xa5, 0x00,			// $f056: LDA CXM0P
+		0x85, 0x80,			// $f058: STA $80
+		0xa5, 0x07,			// $f05a: LDA CXPPMM
+		0x85, 0x81,			// $f05c: STA $81
+		0x85, 0x2c,			// $f05e: STA CXCLR
+		0x4c, 0x3e, 0xf0	// $f060: JMP $f03e
+	};
+
+	// both banks switch to the other one at $f03e, so that the first bank
+	// draws the top of a frame, and the second one the bottom
+	uint8_t data[0x2000];
+	fill_program(data, code, sizeof(code));
+	fill_program(data + 0x1000, code, 0);
+	memcpy(data + 0x103e, switched_code, sizeof(switched_code));
+
+	const racer_atari2600_engine engines[] = {
+		ATARI2600_ENGINE_INTERPRETER,
+		ATARI2600_ENGINE_RECOMPILER,
+		ATARI2600_ENGINE_DIFFERENTIAL
+	};
+
+	// steps of about 3 frames end at different cycles of operations and
+	// scan lines
+	const int steps[] = {7, 113, 1001};
+	bool is_passed = true;
+	for (size_t index = 0; index < sizeof(engines) / sizeof(engines[0]); ++index) {
+		for (size_t step = 0; step < sizeof(steps) / sizeof(steps[0]); ++step) {
+			is_passed &= is_same_stepped(CARTRIDGE_ATARI_8KB, data, engines[index], steps[step], 45000 / steps[step]);
+		}
+	}
+	return is_passed;
+}
+
+
+// MARK: -
+// MARK: Bank switching
+
+/// Writes to bank switching address of an 8KB cartridge through its $1000 mirror, and verifies the
+/// bank is switched, same as writing through its $f000 mirror.
+static bool test_mirrored_bank_switch(void) {
+	const uint8_t code[] = {
+		0x8d, 0xf9, 0x1f,	// $f000: STA $1ff9
+		0x4c, 0x03, 0xf0	// $f003: JMP $f003
+	};
+	const uint8_t switched_code[] = {
+		0xea, 0xea, 0xea,	// $f000: NOP
+		0x4c, 0x06, 0xf0,	// $f003: JMP $f006
+		0x4c, 0x06, 0xf0	// $f006: JMP $f006
+	};
+
+	// both banks start with reset vector pointing to their code
+	uint8_t data[0x2000];
+	fill_program(data, code, sizeof(code));
+	fill_program(data + 0x1000, switched_code, sizeof(switched_code));
+
+	const racer_atari2600_engine engines[] = {
+		ATARI2600_ENGINE_INTERPRETER,
+		ATARI2600_ENGINE_RECOMPILER,
+		ATARI2600_ENGINE_DIFFERENTIAL
+	};
+
+	bool is_passed = true;
+	for (size_t index = 0; index < sizeof(engines) / sizeof(engines[0]); ++index) {
+		racer_atari2600 *console = create_cartridge_console(CARTRIDGE_ATARI_8KB, data, engines[index]);
+		racer_atari2600_run_cycles(console, 1000);
+
+		is_passed &= console->mpu->program_counter >= 0xf006 && console->mpu->program_counter < 0xf009;
+		racer_atari2600_destroy(console);
+	}
+	return is_passed;
+}
+
+
+// MARK: -
+// MARK: Batch
+
+/// The number of consoles, threads and steps of a tested batch; there are more consoles than
+/// threads, so that workers run several of them each.
+#define BATCH_CONSOLE_COUNT 7
+#define BATCH_THREAD_COUNT 3
+#define BATCH_STEP_COUNT 6
+
+/// Standalone console, which draws its frames same as a console in a batch: color clocks drawn past
+/// the end of a frame open the next one.
+typedef struct {
+	racer_atari2600 *console;
+	uint8_t frame[VIDEO_BUFFER_SIZE];
+	uint8_t spill_buffer[VIDEO_BUFFER_SIZE];
+	bool is_spilled;
+} framed_console;
+
+static void sync_framed_video(const void *output, racer_video_sync sync) {
+	if (sync & (VIDEO_VERTICAL_SYNC | VIDEO_BUFFER_SYNC)) {
+		framed_console *framed = (framed_console *)output;
+		framed->console->tia->video_buffer = framed->spill_buffer;
+		framed->console->tia->video_buffer_end = framed->spill_buffer + VIDEO_BUFFER_SIZE;
+		framed->is_spilled = true;
+	}
+}
+
+static void run_framed_console(framed_console *framed) {
+	racer_tia *tia = framed->console->tia;
+	size_t spilled_size = 0;
+	if (framed->is_spilled) {
+		spilled_size = tia->video_buffer - framed->spill_buffer;
+		memcpy(framed->frame, framed->spill_buffer, spilled_size);
+		tia->line_buffer = framed->frame + (tia->line_buffer - framed->spill_buffer);
+		framed->is_spilled = false;
+	}
+
+	tia->video_buffer = framed->frame + spilled_size;
+	tia->video_buffer_end = framed->frame + VIDEO_BUFFER_SIZE;
+	racer_atari2600_run_frame(framed->console);
+}
+
+/// Steps a batch of consoles, which run different cartridges with different engines, on several
+/// threads, and verifies every frame slot is the same as a frame of a standalone console running
+/// the same cartridge, and that workers ran every frame once.
+static bool test_batch(void) {
+	uint8_t code[] = {
+		0xe6, 0x80,			// $f000: INC $80
+		0xa5, 0x80,			// $f002: LDA $80
+		0x85, 0x09,			// $f004: STA COLUBK
+		0xa9, 0x02,			// $f006: LDA #2
+		0x85, 0x00,			// $f008: STA VSYNC
+		0x85, 0x02,			// $f00a: STA WSYNC
+		0x85, 0x02,			// $f00c: STA WSYNC
+		0x85, 0x02,			// $f00e: STA WSYNC
+		0xa9, 0x00,			// $f010: LDA #0
+		0x85, 0x00,			// $f012: STA VSYNC
+		0xa2, 0x00,			// $f014: LDX #line count
+		0x85, 0x02,			// $f016: STA WSYNC
+		0x86, 0x06,			// $f018: STX COLUP0
+		0x86, 0x1b,			// $f01a: STX GRP0
+		0x85, 0x10,			// $f01c: STA RESP0
+		0xca,				// $f01e: DEX
+		0xd0, 0xf5,			// $f01f: BNE $f016
+		0x4c, 0x00, 0xf0	// $f021: JMP $f000
+	};
+
+	const racer_atari2600_engine engines[] = {
+		ATARI2600_ENGINE_INTERPRETER,
+		ATARI2600_ENGINE_RECOMPILER,
+		ATARI2600_ENGINE_DIFFERENTIAL
+	};
+
+	racer_batch *batch = racer_batch_create(BATCH_CONSOLE_COUNT, BATCH_THREAD_COUNT);
+	framed_console *framed_consoles = (framed_console *)calloc(BATCH_CONSOLE_COUNT, sizeof(framed_console));
+	uint8_t *frames = (uint8_t *)calloc(BATCH_CONSOLE_COUNT, VIDEO_BUFFER_SIZE);
+
+	// consoles draw a different number of scan lines, so that frames take
+	// workers uneven time, and a different background color every frame,
+	// so that color clocks opening a frame differ from the previous one
+	for (int index = 0; index < BATCH_CONSOLE_COUNT; ++index) {
+		uint8_t data[0x1000];
+		code[0x15] = 40 + 30 * index;
+		fill_program(data, code, sizeof(code));
+
+		const racer_atari2600_engine engine = engines[index % 3];
+		racer_atari2600 *console = racer_batch_get_console(batch, index);
+		racer_atari2600_insert_cartridge(console, CARTRIDGE_ATARI_4KB, data);
+		racer_atari2600_set_engine(console, engine);
+		racer_atari2600_reset(console);
+
+		framed_console *framed = &framed_consoles[index];
+		framed->console = create_cartridge_console(CARTRIDGE_ATARI_4KB, data, engine);
+		framed->console->tia->video_output = framed;
+		framed->console->tia->sync_video = sync_framed_video;
+		copy_power_on_state(console, framed->console);
+	}
+
+	bool is_passed = true;
+	for (int step = 0; step < BATCH_STEP_COUNT; ++step) {
+		racer_batch_step(batch, NULL, frames, VIDEO_BUFFER_SIZE);
+		for (int index = 0; index < BATCH_CONSOLE_COUNT; ++index) {
+			framed_console *framed = &framed_consoles[index];
+			run_framed_console(framed);
+			is_passed &= memcmp(frames + index * VIDEO_BUFFER_SIZE, framed->frame, VIDEO_BUFFER_SIZE) == 0;
+		}
+	}
+
+	long frame_count = 0;
+	for (int index = 0; index < racer_batch_get_thread_count(batch); ++index) {
+		frame_count += racer_batch_get_worker_stats(batch, index).frame_count;
+	}
+	is_passed &= frame_count == BATCH_CONSOLE_COUNT * BATCH_STEP_COUNT;
+
+	for (int index = 0; index < BATCH_CONSOLE_COUNT; ++index) {
+		racer_atari2600_destroy(framed_consoles[index].console);
+	}
+	free(framed_consoles);
+	free(frames);
+	racer_batch_destroy(batch);
+	return is_passed;
+}
+
+
+// MARK: -
+// MARK: Graphics kernels
+
+/// The number of random TIA states, at which graphics kernels are verified.
+#define KERNEL_STATE_COUNT 20000
+
+/// Returns the next value of a xorshift pseudo-random sequence with the specified state, so that
+/// random TIA states are the same on every run.
+static uint32_t get_random(uint32_t *state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+/// Verifies that the span of color clocks, starting at the current one of the specified TIA, draws
+/// and collides the same as evaluating `get_object_draw_state` at each color clock by itself.
+static bool verify_kernels(const racer_tia *tia, int clocks) {
+	uint8_t colors[228];
+	racer_tia kernel = *tia;
+	kernel.video_buffer = colors;
+	kernel.collisions = 0;
+	draw_graphics(&kernel, clocks);
+	add_collisions(&kernel, clocks);
+
+	uint8_t reference_colors[228];
+	racer_tia reference = *tia;
+	reference.collisions = 0;
+	for (int clock = 0; clock < clocks; ++clock) {
+		const uint16_t state = get_object_draw_state(&reference);
+		reference_colors[clock] = reference.colors[draw_indices[state]];
+		reference.collisions |= collisions[state >> 3];
+		reference.position_clock += 1;
+		reference.color_clock += 1;
+	}
+
+	return memcmp(colors, reference_colors, clocks) == 0 && kernel.collisions == reference.collisions;
+}
+
+/// Writes random values to graphics registers of TIA at random color clocks, and verifies graphics
+/// kernels against draw states at every span past horizontal blanking, which ends before any
+/// position counter wraps around.
+static bool test_graphics_kernels(void) {
+	const uint8_t code[] = {
+		0x4c, 0x00, 0xf0	// $f000: JMP $f000
+	};
+	racer_atari2600 *console = create_console(code, sizeof(code), ATARI2600_ENGINE_INTERPRETER);
+	racer_tia *tia = console->tia;
+
+	uint32_t random = 0x2600;
+	int verified_count = 0;
+	bool is_passed = true;
+	while (verified_count < KERNEL_STATE_COUNT) {
+		// all registers from NUSIZ0 to HMCLR, including position resets and
+		// HMOVE, but neither sync, nor blanking
+		const uint8_t address = 0x04 + get_random(&random) % (0x2c - 0x04);
+		racer_tia_write(tia, address, get_random(&random));
+		racer_tia_write(tia, 0x01, 0x00);
+
+		const int advanced_clocks = get_random(&random) % 40;
+		for (int clock = 0; clock < advanced_clocks; ++clock) {
+			racer_tia_advance_clock(tia);
+		}
+		if (tia->color_clock < tia->blank_reset_clock || tia->color_clock >= 228) {
+			continue;
+		}
+
+		// spans end with scan line, or before position counter of any
+		// object wraps around
+		const int line_clocks = 228 - tia->color_clock;
+		const int wrap_clocks = tia->wrap_clock - tia->position_clock - 1;
+		const int clocks = (wrap_clocks < line_clocks) ? wrap_clocks : line_clocks;
+		if (clocks > 0) {
+			is_passed &= verify_kernels(tia, clocks);
+			verified_count += 1;
+		}
+	}
+
+	racer_atari2600_destroy(console);
+	return is_passed;
+}
+
+/// Polls timer interrupt flag, after edge detect interrupt flag is set, and verifies skipped
+/// iterations of the polling loop read it cleared after the first one, same as running a cycle at a
+/// time.
+static bool test_edge_detect_poll(void) {
+	const uint8_t code[] = {
+		0xad, 0x80, 0x02,	// $f000: LDA SWCHA
+		0xa9, 0x80,			// $f003: LDA #$80
+		0x8d, 0x81, 0x02,	// $f005: STA SWACNT
+		0xa9, 0x20,			// $f008: LDA #$20
+		0x8d, 0x96, 0x02,	// $f00a: STA TIM64T
+		0xad, 0x80, 0x02,	// $f00d: LDA SWCHA
+		0x4c, 0x13, 0xf0,	// $f010: JMP $f013
+		0x2c, 0x85, 0x02,	// $f013: BIT TIMINT
+		0x10, 0xfb,			// $f016: BPL $f013
+		0xa9, 0x00,			// $f018: LDA #0
+		0x8d, 0x81, 0x02,	// $f01a: STA SWACNT
+		0x4c, 0x00, 0xf0	// $f01d: JMP $f000
+	};
+
+	// PA7 falls from input to output, which sets edge detect interrupt
+	// flag before every polling loop; the loop starts a block of its own,
+	// so that skipping starts with its first read
+	const racer_atari2600_engine engines[] = {
+		ATARI2600_ENGINE_INTERPRETER,
+		ATARI2600_ENGINE_RECOMPILER,
+		ATARI2600_ENGINE_DIFFERENTIAL
+	};
+
+	uint8_t data[0x1000];
+	fill_program(data, code, sizeof(code));
+
+	// steps end at different cycles of skipped iterations
+	bool is_passed = true;
+	for (size_t index = 0; index < sizeof(engines) / sizeof(engines[0]); ++index) {
+		for (int step = 297; step <= 305; step += 2) {
+			is_passed &= is_same_stepped(CARTRIDGE_ATARI_4KB, data, engines[index], step, 100);
+		}
+	}
+	return is_passed;
+}
+
+
+// MARK: -
+
+static const test_case test_cases[] = {
+	{"stopped timer", test_stopped_timer},
+	{"stepped kernel", test_stepped_kernel},
+	{"edge detect poll", test_edge_detect_poll},
+	{"mirrored bank switch", test_mirrored_bank_switch},
+	{"batch", test_batch},
+	{"graphics kernels", test_graphics_kernels}
+};
+
+/// Runs all test cases of librayracer, and reports the ones, which fail.
+///
+/// Usage: rayracer-test
+int main(int argc, const char *argv[]) {
+	int failure_count = 0;
+	for (size_t index = 0; index < sizeof(test_cases) / sizeof(test_cases[0]); ++index) {
+		const bool is_passed = test_cases[index].run();
+		printf("%s: %s\n", test_cases[index].name, is_passed ? "passed" : "FAILED");
+		failure_count += !is_passed;
+	}
+
+	printf("%d of %d test cases failed\n", failure_count, (int)(sizeof(test_cases) / sizeof(test_cases[0])));
+	return (failure_count > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
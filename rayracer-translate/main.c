@@ -0,0 +1,71 @@
+//
+//  main.c
+//  rayracer-translate
+//
+//  Created by Serge Tsyba on 15.10.2026.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "translator.h"
+
+/// Returns type of a cartridge with the specified ROM size; -1 when no cartridge type has such size.
+static int get_cartridge_type(long size) {
+	switch (size) {
+		case 0x800:
+			return CARTRIDGE_ATARI_2KB;
+		case 0x1000:
+			return CARTRIDGE_ATARI_4KB;
+		case 0x2000:
+			return CARTRIDGE_ATARI_8KB;
+		case 0x3000:
+			return CARTRIDGE_ATARI_12KB;
+		case 0x4000:
+			return CARTRIDGE_ATARI_16KB;
+		case 0x8000:
+			return CARTRIDGE_ATARI_32KB;
+		default:
+			return -1;
+	}
+}
+
+/// Translates cartridge ROM into C translation unit, which runs its code, when linked with librayracer.
+///
+/// Usage: rayracer-translate <rom> <name> [<output>]
+int main(int argc, const char *argv[]) {
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s <rom> <name> [<output>]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FILE *input = fopen(argv[1], "rb");
+	if (input == NULL) {
+		fprintf(stderr, "%s: cannot open ROM: %s\n", argv[0], argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	uint8_t data[0x8000 + 1];
+	const long size = fread(data, 1, sizeof(data), input);
+	fclose(input);
+
+	const int type = get_cartridge_type(size);
+	if (type < 0) {
+		fprintf(stderr, "%s: unsupported ROM size: %ld\n", argv[0], size);
+		return EXIT_FAILURE;
+	}
+
+	FILE *output = (argc > 3) ? fopen(argv[3], "w") : stdout;
+	if (output == NULL) {
+		fprintf(stderr, "%s: cannot open output: %s\n", argv[0], argv[3]);
+		return EXIT_FAILURE;
+	}
+
+	const int block_count = racer_translator_translate(type, data, argv[2], output);
+	if (output != stdout) {
+		fclose(output);
+	}
+
+	fprintf(stderr, "%s: translated %d basic blocks\n", argv[0], block_count);
+	return EXIT_SUCCESS;
+}